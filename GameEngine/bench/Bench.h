@@ -0,0 +1,56 @@
+// A small harness shared by the benchmarks in this directory.
+// Every benchmark is a program of its own. Build it from the GameEngine
+// directory with the engine sources listed at the top of its file, e.g.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/JobSystemBench.cpp core/JobSystem.cpp math/*.cpp
+//         util/MeasurementUnits.cpp util/Timer.cpp -o jobsystem_bench
+//
+// The include paths are the ones of the engine's project, whose sources include
+// some headers of other directories by name alone.
+//
+// Results are printed as the fastest of several runs, since the slower runs
+// mostly measure the rest of the machine.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdio>
+#include <cstdint>
+
+#include "../util/Timer.h"
+
+// Runs the function 'runs' times and returns the fastest run, in seconds.
+template<typename Func>
+double measureFastest(unsigned runs, Func func){
+    double fastest = 0;
+
+    for (unsigned run = 0; run < runs; run++){
+        uint64_t start = Timer::now();
+        func();
+        double seconds = (Timer::now() - start) / 1e9;
+
+        if (run == 0 || seconds < fastest)
+            fastest = seconds;
+    }
+
+    return fastest;
+}
+
+// Keeps the compiler from dropping the computation of a value nothing reads.
+template<typename T>
+void keepValue(const T& value){
+    volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+    (void)sink;
+}
+
+// Prints the time per item and the items per second of a measurement.
+inline void printResult(const char* name, double seconds, double items){
+    printf("  %-40s %10.2f ns/item %10.2f M items/s\n", name, seconds * 1e9 / items, items / seconds / 1e6);
+}
+
+// Prints how many times faster the new measurement is than the old one.
+inline void printSpeedup(const char* name, double oldSeconds, double newSeconds){
+    printf("  %-40s %10.2fx\n", name, oldSeconds / newSeconds);
+}
+
+#endif // BENCH_H
@@ -0,0 +1,99 @@
+/*
+    Spawning and despawning components through the chunked pools, against a heap
+    allocation per component as the multimap manager did.
+
+        g++ -std=c++11 -O2 -pthread -I. bench/ComponentSpawnBench.cpp components/ComponentManager.cpp \
+            components/ComponentPool.cpp components/ComponentType.cpp components/Component.cpp \
+            util/ChunkAllocator.cpp util/Timer.cpp -o component_spawn_bench
+
+    Usage: component_spawn_bench [component count, 1000000 by default]
+*/
+
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "Bench.h"
+#include "baseline/MultimapComponentManager.h"
+#include "../components/ComponentManager.h"
+
+// The size of a Transform, without its dependencies on the engine.
+struct SpawnedComponent : public Component{
+    SpawnedComponent(unsigned entityId) : Component(entityId), scale{1, 1, 1}, rotation{1, 0, 0, 0} {}
+
+    float position[3];
+    float scale[3];
+    float rotation[4];
+};
+
+static const unsigned RUNS = 5;
+
+static void printStats(const char* name, const AllocatorStats& stats){
+    printf("  %-40s %8.2f MB live %8.2f MB reserved %6u chunks in use %6u free %5.1f%% fragmentation\n", name,
+           stats.bytesLive / 1048576.0, stats.bytesReserved / 1048576.0,
+           stats.chunksInUse, stats.chunksFree, stats.fragmentation() * 100);
+}
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    printf("%u components\n", count);
+
+    // Despawning in a random order, as a game would, leaves holes the pool has to fill.
+    std::vector<unsigned> despawnOrder(count);
+    for (unsigned i = 0; i < count; i++)
+        despawnOrder[i] = i;
+    std::shuffle(despawnOrder.begin(), despawnOrder.end(), std::mt19937(1));
+
+    MultimapComponentManager multimap;
+    ComponentManager pools;
+
+    double multimapSpawn = 0, multimapDespawn = 0;
+    double poolSpawn = 0, poolDespawn = 0;
+
+    // Spawning measures the pool growing the first time, and reusing its free chunks after.
+    for (unsigned run = 0; run < RUNS; run++){
+        double seconds = measureFastest(1, [&](){
+            for (unsigned id = 0; id < count; id++)
+                multimap.addComponent<SpawnedComponent>(id);
+        });
+        multimapSpawn = run == 0 ? seconds : std::min(multimapSpawn, seconds);
+
+        seconds = measureFastest(1, [&](){
+            for (unsigned id : despawnOrder)
+                multimap.removeComponent<SpawnedComponent>(id);
+        });
+        multimapDespawn = run == 0 ? seconds : std::min(multimapDespawn, seconds);
+
+        seconds = measureFastest(1, [&](){
+            for (unsigned id = 0; id < count; id++)
+                pools.addComponent<SpawnedComponent>(id);
+        });
+        poolSpawn = run == 0 ? seconds : std::min(poolSpawn, seconds);
+
+        if (run == 0)
+            printStats("pools after spawning", pools.getStats());
+
+        seconds = measureFastest(1, [&](){
+            for (unsigned id : despawnOrder)
+                pools.removeComponent<SpawnedComponent>(id);
+        });
+        poolDespawn = run == 0 ? seconds : std::min(poolDespawn, seconds);
+
+        if (run == 0)
+            printStats("pools after despawning", pools.getStats());
+    }
+
+    printf("Spawn\n");
+    printResult("new, multimap", multimapSpawn, count);
+    printResult("pool", poolSpawn, count);
+    printSpeedup("pool speedup", multimapSpawn, poolSpawn);
+
+    printf("Despawn, in random order\n");
+    printResult("delete, multimap", multimapDespawn, count);
+    printResult("pool", poolDespawn, count);
+    printSpeedup("pool speedup", multimapDespawn, poolDespawn);
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+    Iteration and lookup throughput of the packed component pools, against the
+    multimap the components used to live in.
+
+        g++ -std=c++11 -O2 -pthread -I. bench/ComponentStorageBench.cpp components/ComponentManager.cpp \
+            components/ComponentPool.cpp components/ComponentType.cpp components/Component.cpp \
+            util/ChunkAllocator.cpp util/Timer.cpp -o component_storage_bench
+
+    Usage: component_storage_bench [entity count, 100000 by default]
+*/
+
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "Bench.h"
+#include "baseline/MultimapComponentManager.h"
+#include "../components/ComponentManager.h"
+
+// The data of a Transform, without its dependencies on the engine.
+struct BenchTransform : public Component{
+    BenchTransform(unsigned entityId) : Component(entityId), scale{1, 1, 1}, rotation{1, 0, 0, 0} {}
+
+    float position[3];
+    float scale[3];
+    float rotation[4];
+};
+
+static const unsigned RUNS = 10;
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    printf("%u entities, one component each\n", count);
+
+    std::vector<unsigned> ids(count);
+    for (unsigned i = 0; i < count; i++)
+        ids[i] = i;
+
+    std::vector<unsigned> shuffled(ids);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+
+    MultimapComponentManager multimap;
+    ComponentManager pools;
+
+    for (unsigned id : ids){
+        multimap.addComponent<BenchTransform>(id)->position[0] = float(id);
+        pools.addComponent<BenchTransform>(id)->position[0] = float(id);
+    }
+
+    // Iterating means a lookup per entity in the multimap, and a linear sweep of the pool.
+    double multimapIteration = measureFastest(RUNS, [&](){
+        float sum = 0;
+        for (unsigned id : ids)
+            sum += multimap.getComponent<BenchTransform>(id)->position[0];
+        keepValue(sum);
+    });
+
+    double poolIteration = measureFastest(RUNS, [&](){
+        float sum = 0;
+        ComponentPool<BenchTransform>& pool = pools.getPool<BenchTransform>();
+        for (unsigned chunk = 0; chunk < pool.getChunkCount(); chunk++){
+            const BenchTransform* components = pool.getChunk(chunk);
+            for (unsigned i = 0; i < pool.getChunkLength(chunk); i++)
+                sum += components[i].position[0];
+        }
+        keepValue(sum);
+    });
+
+    double viewIteration = measureFastest(RUNS, [&](){
+        float sum = 0;
+        pools.view<BenchTransform>().each([&sum](unsigned, BenchTransform& transform){
+            sum += transform.position[0];
+        });
+        keepValue(sum);
+    });
+
+    // Random lookups, e.g. following references between entities.
+    double multimapLookup = measureFastest(RUNS, [&](){
+        float sum = 0;
+        for (unsigned id : shuffled)
+            sum += multimap.getComponent<BenchTransform>(id)->position[0];
+        keepValue(sum);
+    });
+
+    double poolLookup = measureFastest(RUNS, [&](){
+        float sum = 0;
+        for (unsigned id : shuffled)
+            sum += pools.getComponent<BenchTransform>(id)->position[0];
+        keepValue(sum);
+    });
+
+    printf("Iteration\n");
+    printResult("multimap, lookup per entity", multimapIteration, count);
+    printResult("pool, chunk sweep", poolIteration, count);
+    printResult("pool, view", viewIteration, count);
+    printSpeedup("chunk sweep speedup", multimapIteration, poolIteration);
+
+    printf("Random lookup\n");
+    printResult("multimap", multimapLookup, count);
+    printResult("pool", poolLookup, count);
+    printSpeedup("pool speedup", multimapLookup, poolLookup);
+
+    return 0;
+}
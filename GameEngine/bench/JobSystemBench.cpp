@@ -0,0 +1,61 @@
+// How a transform update scales with the threads of the job system, from the
+// main thread alone up to one thread per hardware thread.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/JobSystemBench.cpp core/JobSystem.cpp math/*.cpp
+//         util/MeasurementUnits.cpp util/Timer.cpp -o jobsystem_bench
+//
+// Usage: jobsystem_bench [transform count, 1000000 by default] [most threads, hardware threads by default]
+
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "Bench.h"
+#include "../core/JobSystem.h"
+#include "../math/Matrix3x4.h"
+
+static const unsigned RUNS = 10;
+static const unsigned GRAIN_SIZE = 4096;
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    unsigned maxThreads = argc > 2 ? strtoul(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    printf("%u transforms, grain size %u\n", count, GRAIN_SIZE);
+
+    std::vector<Vector3> positions(count);
+    std::vector<Quaternion> rotations(count);
+    std::vector<Vector3> scales(count, Vector3(1, 1, 1));
+    std::vector<Matrix3x4> matrices(count);
+
+    for (unsigned i = 0; i < count; i++){
+        positions[i] = Vector3(float(i), float(i % 7), float(i % 13));
+        rotations[i] = Quaternion(Degrees(float(i % 360)), Vector3(0, 1, 0));
+    }
+
+    auto update = [&](unsigned first, unsigned last){
+        for (unsigned i = first; i < last; i++)
+            matrices[i] = Matrix3x4::fromTRS(positions[i], rotations[i], scales[i]);
+    };
+
+    // The main thread always takes part, so one thread is zero workers.
+    double single = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads++){
+        JobSystem jobs(threads - 1);
+
+        double seconds = measureFastest(RUNS, [&](){
+            jobs.parallelFor(0, count, GRAIN_SIZE, update);
+        });
+        keepValue(matrices[count / 2]);
+
+        if (threads == 1)
+            single = seconds;
+
+        printf("%u thread%s\n", threads, threads == 1 ? "" : "s");
+        printResult("transform update", seconds, count);
+        printSpeedup("speedup over one thread", single, seconds);
+    }
+
+    return 0;
+}
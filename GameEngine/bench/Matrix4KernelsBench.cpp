@@ -0,0 +1,149 @@
+// Throughput of the 4x4 matrix kernels of every instruction set the processor
+// supports, against the scalar ones.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/Matrix4KernelsBench.cpp math/Matrix4Kernels.cpp
+//         math/SIMD.cpp util/Timer.cpp -o matrix4_kernels_bench
+//
+// Usage: matrix4_kernels_bench [matrix count, 10000 by default]
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "Bench.h"
+#include "../math/Matrix4Kernels.h"
+
+static const unsigned RUNS = 20;
+
+static const char* const SIMD_LEVEL_NAMES[] = { "scalar", "SSE2", "AVX and FMA" };
+
+// Every kernel, timed over the same matrices.
+struct KernelTimes{
+    double multiply;
+    double transform;
+    double transpose;
+    double inverse;
+};
+
+static KernelTimes measureKernels(const Matrix4Kernels& kernels, const std::vector<float>& matrices,
+                                  const std::vector<float>& vectors, std::vector<float>& results){
+    unsigned count = matrices.size() / 16;
+    const float* m = matrices.data();
+    const float* v = vectors.data();
+    float* r = results.data();
+
+    KernelTimes times;
+
+    // Each matrix times the next one, as when concatenating transforms.
+    times.multiply = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i + 1 < count; i++)
+            kernels.multiply(m + i * 16, m + (i + 1) * 16, r + i * 16);
+        keepValue(r[0]);
+    });
+
+    times.transform = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            kernels.transform(m + i * 16, v + i * 4, r + i * 4);
+        keepValue(r[0]);
+    });
+
+    times.transpose = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            kernels.transpose(m + i * 16, r + i * 16);
+        keepValue(r[0]);
+    });
+
+    times.inverse = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            kernels.inverse(m + i * 16, r + i * 16);
+        keepValue(r[0]);
+    });
+
+    return times;
+}
+
+// The largest difference between the results of the kernels and the scalar ones.
+static float compareKernels(const Matrix4Kernels& kernels, const Matrix4Kernels& scalar, const std::vector<float>& matrices){
+    unsigned count = matrices.size() / 16;
+    float difference = 0;
+
+    for (unsigned i = 0; i + 1 < count; i++){
+        const float* a = &matrices[i * 16];
+        const float* b = &matrices[(i + 1) * 16];
+        float expected[16], result[16];
+
+        scalar.multiply(a, b, expected);
+        kernels.multiply(a, b, result);
+        for (unsigned j = 0; j < 16; j++)
+            difference = std::max(difference, std::fabs(expected[j] - result[j]));
+
+        scalar.transform(a, b, expected);
+        kernels.transform(a, b, result);
+        for (unsigned j = 0; j < 4; j++)
+            difference = std::max(difference, std::fabs(expected[j] - result[j]));
+
+        scalar.transpose(a, expected);
+        kernels.transpose(a, result);
+        for (unsigned j = 0; j < 16; j++)
+            difference = std::max(difference, std::fabs(expected[j] - result[j]));
+
+        if (scalar.inverse(a, expected) && kernels.inverse(a, result))
+            for (unsigned j = 0; j < 16; j++)
+                difference = std::max(difference, std::fabs(expected[j] - result[j]));
+    }
+
+    return difference;
+}
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+    printf("%u matrices, processor supports %s\n", count, SIMD_LEVEL_NAMES[getSIMDLevel()]);
+
+    // Affine transforms with a well conditioned rotation and scale, like the ones of a scene.
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+
+    std::vector<float> matrices(count * 16);
+    std::vector<float> vectors(count * 4);
+    std::vector<float> results(count * 16);
+
+    for (unsigned i = 0; i < count; i++){
+        float* m = &matrices[i * 16];
+        for (unsigned j = 0; j < 12; j++)
+            m[j] = distribution(random);
+        for (unsigned j = 0; j < 3; j++)
+            m[j * 5] += 4;
+        m[12] = m[13] = m[14] = 0;
+        m[15] = 1;
+
+        for (unsigned j = 0; j < 4; j++)
+            vectors[i * 4 + j] = distribution(random);
+    }
+
+    const Matrix4Kernels& scalar = getMatrix4Kernels(SIMD_SCALAR);
+    KernelTimes scalarTimes = measureKernels(scalar, matrices, vectors, results);
+
+    for (unsigned level = SIMD_SCALAR; level <= unsigned(getSIMDLevel()); level++){
+        const Matrix4Kernels& kernels = getMatrix4Kernels(SIMDLevel(level));
+        KernelTimes times = level == SIMD_SCALAR ? scalarTimes : measureKernels(kernels, matrices, vectors, results);
+
+        printf("%s\n", SIMD_LEVEL_NAMES[level]);
+        printResult("multiply", times.multiply, count - 1);
+        printResult("transform", times.transform, count);
+        printResult("transpose", times.transpose, count);
+        printResult("inverse", times.inverse, count);
+
+        if (level != SIMD_SCALAR){
+            printSpeedup("multiply speedup", scalarTimes.multiply, times.multiply);
+            printSpeedup("transform speedup", scalarTimes.transform, times.transform);
+            printSpeedup("transpose speedup", scalarTimes.transpose, times.transpose);
+            printSpeedup("inverse speedup", scalarTimes.inverse, times.inverse);
+            printf("  %-40s %10.2g\n", "largest difference to scalar", compareKernels(kernels, scalar, matrices));
+        }
+    }
+
+    return 0;
+}
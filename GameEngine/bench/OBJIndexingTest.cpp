@@ -0,0 +1,243 @@
+// Checks that the hashed vertex deduplication of OBJModel::ToIndexedModel builds
+// the same triangles as the indexing it replaced, on synthetic models.
+//
+// Every corner of every triangle must have the same position, uv and normal.
+// The vertex counts are allowed to differ: the previous indexing often missed
+// a vertex it had already created and added it again, so it can only have more
+// vertices, while the new one has exactly one per distinct index triple.
+// Generated normals are weighted by angle instead of uniformly, so they are only
+// checked to be unit length and on the same side as the previous ones.
+// Triangles with out of range indices are dropped by the new loader, while the
+// previous one read past its arrays. Those are compared to the previous indexing
+// of the same file without the bad faces.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/OBJIndexingTest.cpp bench/baseline/BaselineOBJModel.cpp
+//         util/OBJModel.cpp util/MappedFile.cpp util/Profiler.cpp util/Timer.cpp util/MeasurementUnits.cpp
+//         core/JobSystem.cpp math/*.cpp -o obj_indexing_test
+//
+// Returns 0 if every model matches.
+
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <set>
+#include <tuple>
+#include <random>
+
+#include "baseline/BaselineOBJModel.h"
+#include "../util/OBJModel.h"
+#include "../core/JobSystem.h"
+
+static const float TOLERANCE = 1e-5f;
+
+static const char* const TEST_FILE = "obj_indexing_test.obj";
+
+static bool nearlyEqual(const Vector3& a, const Vector3& b){
+    return std::fabs(a.x - b.x) <= TOLERANCE && std::fabs(a.y - b.y) <= TOLERANCE && std::fabs(a.z - b.z) <= TOLERANCE;
+}
+
+static bool nearlyEqual(const Vector2& a, const Vector2& b){
+    return std::fabs(a.x - b.x) <= TOLERANCE && std::fabs(a.y - b.y) <= TOLERANCE;
+}
+
+static bool writeFile(const std::string& contents){
+    FILE* file = fopen(TEST_FILE, "w");
+    if (!file){
+        fprintf(stderr, "Could not write %s\n", TEST_FILE);
+        return false;
+    }
+    fputs(contents.c_str(), file);
+    fclose(file);
+    return true;
+}
+
+// Indexes the file with the new version, and the expected contents with the previous
+// one, and compares them. Returns false on the first difference.
+static bool compareIndexing(const std::string& name, const std::string& contents,
+                            const std::string& expectedContents, JobSystem* jobSystem){
+    if (!writeFile(expectedContents))
+        return false;
+
+    BaselineOBJModel baselineOBJ(TEST_FILE);
+    BaselineIndexedModel expected = baselineOBJ.ToIndexedModel();
+
+    if (!writeFile(contents))
+        return false;
+
+    OBJModel obj(TEST_FILE, jobSystem);
+    IndexedModel result = obj.ToIndexedModel(jobSystem);
+
+    remove(TEST_FILE);
+
+    if (result.indices.size() != expected.indices.size()){
+        fprintf(stderr, "%s: %u indices, expected %u\n", name.c_str(),
+                unsigned(result.indices.size()), unsigned(expected.indices.size()));
+        return false;
+    }
+
+    if (result.positions.size() > expected.positions.size()){
+        fprintf(stderr, "%s: %u vertices, more than the %u of the previous indexing\n", name.c_str(),
+                unsigned(result.positions.size()), unsigned(expected.positions.size()));
+        return false;
+    }
+
+    std::set<std::tuple<unsigned, unsigned, unsigned> > triples;
+    for (const OBJIndex& index : obj.OBJIndices)
+        triples.insert(std::make_tuple(index.vertexIndex, obj.hasUVs ? index.uvIndex : 0, obj.hasNormals ? index.normalIndex : 0));
+
+    if (result.positions.size() != triples.size()){
+        fprintf(stderr, "%s: %u vertices for %u distinct index triples\n", name.c_str(),
+                unsigned(result.positions.size()), unsigned(triples.size()));
+        return false;
+    }
+
+    for (unsigned i = 0; i < result.indices.size(); i++){
+        unsigned vertex = result.indices[i];
+        unsigned expectedVertex = expected.indices[i];
+
+        bool same = nearlyEqual(result.positions[vertex], expected.positions[expectedVertex])
+                 && nearlyEqual(result.texCoords[vertex], expected.texCoords[expectedVertex]);
+
+        const Vector3& normal = result.normals[vertex];
+        const Vector3& expectedNormal = expected.normals[expectedVertex];
+
+        if (obj.hasNormals)
+            same = same && nearlyEqual(normal, expectedNormal);
+        else
+            same = same && std::fabs(normal.magnitude() - 1) <= TOLERANCE && normal.dot(expectedNormal) > 0;
+
+        if (!same){
+            fprintf(stderr, "%s: corner %u of triangle %u differs\n", name.c_str(), i % 3, i / 3);
+            return false;
+        }
+    }
+
+    printf("%-40s %6u indices %6u vertices, %u before\n", name.c_str(), unsigned(result.indices.size()),
+           unsigned(result.positions.size()), unsigned(expected.positions.size()));
+    return true;
+}
+
+static bool compareIndexing(const std::string& name, const std::string& contents, JobSystem* jobSystem){
+    return compareIndexing(name, contents, contents, jobSystem);
+}
+
+// The 8 corners of a cube with outward faces, as quads.
+static std::string cubePositions(){
+    return "v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\n"
+           "v -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n";
+}
+
+// A cube whose corners are shared by the faces around them.
+static std::string positionsOnly(){
+    return cubePositions() +
+           "f 1 4 3\nf 1 3 2\nf 5 6 7\nf 5 7 8\nf 1 2 6\nf 1 6 5\n"
+           "f 4 8 7\nf 4 7 3\nf 1 5 8\nf 1 8 4\nf 2 3 7\nf 2 7 6\n";
+}
+
+// The same cube with a uv island per face, so corners are split along the seams.
+static std::string withUVs(){
+    return cubePositions() + "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+           "f 1/1 4/4 3/3\nf 1/1 3/3 2/2\nf 5/1 6/2 7/3\nf 5/1 7/3 8/4\nf 1/1 2/2 6/3\nf 1/1 6/3 5/4\n"
+           "f 4/1 8/2 7/3\nf 4/1 7/3 3/4\nf 1/1 5/2 8/3\nf 1/1 8/3 4/4\nf 2/1 3/2 7/3\nf 2/1 7/3 6/4\n";
+}
+
+// A flat shaded cube as quads, split into triangle fans, with a normal per face.
+static std::string quadsWithNormals(){
+    return cubePositions() + "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+           "vn 0 0 -1\nvn 0 0 1\nvn 0 -1 0\nvn 0 1 0\nvn -1 0 0\nvn 1 0 0\n"
+           "f 1/1/1 4/2/1 3/3/1 2/4/1\nf 5/1/2 6/2/2 7/3/2 8/4/2\nf 1/1/3 2/2/3 6/3/3 5/4/3\n"
+           "f 4/1/4 8/2/4 7/3/4 3/4/4\nf 1/1/5 5/2/5 8/3/5 4/4/5\nf 2/1/6 3/2/6 7/3/6 6/4/6\n";
+}
+
+// The faces of the cube with uvs and normals, and faces whose position, uv or normal
+// index is out of range: 0, past the end, or relative from before the start.
+// Also a quad with one bad corner, of which only the triangle without it is kept.
+static std::string outOfRangeFaces(){
+    return "f 1/1/1 2/2/1 9/3/1\nf 0/1/1 2/2/1 3/3/1\nf 1/5/1 2/2/1 3/3/1\nf 1/1/7 2/2/1 3/3/1\n"
+           "f -9/1/1 2/2/1 3/3/1\nf 1/1/1 2/2/1 3/3/1 12/4/1\n";
+}
+
+// A bumpy grid with positions, uvs and normals, where uvs wrap around every
+// few columns so the same positions are used with different uvs.
+static std::string grid(unsigned size){
+    std::string contents;
+    char line[128];
+    unsigned side = size + 1;
+
+    for (unsigned row = 0; row < side; row++){
+        for (unsigned column = 0; column < side; column++){
+            snprintf(line, sizeof(line), "v %u %u %u\nvn 0 1 0\n", column, (row * 7 + column * 3) % 5, row);
+            contents += line;
+        }
+    }
+
+    for (unsigned u = 0; u < 4; u++){
+        snprintf(line, sizeof(line), "vt %g 0\n", u / 3.0);
+        contents += line;
+    }
+
+    for (unsigned row = 0; row < size; row++){
+        for (unsigned column = 0; column < size; column++){
+            unsigned a = row * side + column + 1;
+            unsigned b = a + 1;
+            unsigned c = a + side;
+            unsigned d = c + 1;
+            unsigned u = column % 3 + 1;
+
+            snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, u, a, c, u, c, b, u + 1, b);
+            contents += line;
+            snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", b, u + 1, b, c, u, c, d, u + 1, d);
+            contents += line;
+        }
+    }
+
+    return contents;
+}
+
+// Triangles over random index triples from small pools, so most triples repeat.
+static std::string randomTriples(unsigned triangles){
+    std::mt19937 random(1);
+    std::string contents;
+    char line[128];
+
+    for (unsigned i = 0; i < 20; i++){
+        snprintf(line, sizeof(line), "v %u %u %u\nvt %u 0\nvn 0 0 %u\n", i, i * i % 7, i % 3, i % 5, i + 1);
+        contents += line;
+    }
+
+    std::uniform_int_distribution<unsigned> index(1, 20);
+    for (unsigned i = 0; i < triangles; i++){
+        unsigned v[3];
+        v[0] = index(random);
+        do v[1] = index(random); while (v[1] == v[0]);
+        do v[2] = index(random); while (v[2] == v[0] || v[2] == v[1]);
+
+        contents += "f";
+        for (unsigned j = 0; j < 3; j++){
+            snprintf(line, sizeof(line), " %u/%u/%u", v[j], index(random) % 4 + 1, v[j]);
+            contents += line;
+        }
+        contents += "\n";
+    }
+
+    return contents;
+}
+
+int main(){
+
+    JobSystem jobSystem;
+    bool passed = true;
+
+    // The job system only splits large models, the others run on one thread either way.
+    passed = compareIndexing("positions only", positionsOnly(), nullptr) && passed;
+    passed = compareIndexing("positions and uvs", withUVs(), nullptr) && passed;
+    passed = compareIndexing("quads with normals", quadsWithNormals(), nullptr) && passed;
+    passed = compareIndexing("grid", grid(40), nullptr) && passed;
+    passed = compareIndexing("grid, job system", grid(120), &jobSystem) && passed;
+    passed = compareIndexing("random repeated triples", randomTriples(2000), nullptr) && passed;
+    passed = compareIndexing("out of range indices", quadsWithNormals() + outOfRangeFaces(),
+                             quadsWithNormals() + "f 1/1/1 2/2/1 3/3/1\n", nullptr) && passed;
+
+    printf(passed ? "All models match\n" : "Some models differ\n");
+    return passed ? 0 : 1;
+}
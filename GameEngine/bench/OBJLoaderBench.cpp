@@ -0,0 +1,109 @@
+// Load time of the memory mapped OBJ parser, on one thread and on the job system,
+// against the getline and SplitString loader it replaced, on a synthetic grid.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/OBJLoaderBench.cpp bench/baseline/BaselineOBJModel.cpp
+//         util/OBJModel.cpp util/MappedFile.cpp util/Profiler.cpp util/Timer.cpp util/MeasurementUnits.cpp
+//         core/JobSystem.cpp math/*.cpp -o obj_loader_bench
+//
+// Usage: obj_loader_bench [grid size in quads per side, 1000 by default] [file, obj_loader_bench.obj by default]
+
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+
+#include "Bench.h"
+#include "baseline/BaselineOBJModel.h"
+#include "../util/OBJModel.h"
+#include "../core/JobSystem.h"
+
+static const unsigned RUNS = 3;
+
+// A grid of size x size quads, as two triangles each, with positions, uvs and normals.
+// Vertices are written in rows, so faces refer back to recent lines like exported meshes do.
+static bool writeGrid(const std::string& fileName, unsigned size){
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file){
+        fprintf(stderr, "Could not write %s\n", fileName.c_str());
+        return false;
+    }
+
+    unsigned side = size + 1;
+    fprintf(file, "# %u x %u grid\n", size, size);
+
+    for (unsigned row = 0; row < side; row++)
+        for (unsigned column = 0; column < side; column++)
+            fprintf(file, "v %f %f %f\n", column * 0.01f, 0.05f * ((row * 7 + column * 3) % 11), row * 0.01f);
+
+    for (unsigned row = 0; row < side; row++)
+        for (unsigned column = 0; column < side; column++)
+            fprintf(file, "vt %f %f\n", float(column) / size, float(row) / size);
+
+    for (unsigned row = 0; row < side; row++)
+        for (unsigned column = 0; column < side; column++)
+            fprintf(file, "vn %f %f %f\n", 0.0f, 1.0f, 0.0f);
+
+    // OBJ indices start at 1.
+    for (unsigned row = 0; row < size; row++){
+        for (unsigned column = 0; column < size; column++){
+            unsigned a = row * side + column + 1;
+            unsigned b = a + 1;
+            unsigned c = a + side;
+            unsigned d = c + 1;
+
+            fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, c, c, c, b, b, b);
+            fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", b, b, b, c, c, c, d, d, d);
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv){
+
+    unsigned size = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+    std::string fileName = argc > 2 ? argv[2] : "obj_loader_bench.obj";
+
+    if (!writeGrid(fileName, size))
+        return 1;
+
+    unsigned triangles = size * size * 2;
+    printf("%u triangles, %u vertices\n", triangles, (size + 1) * (size + 1));
+
+    JobSystem jobSystem;
+
+    size_t baselineFaces = 0, faces = 0, parallelFaces = 0;
+
+    double baseline = measureFastest(RUNS, [&](){
+        BaselineOBJModel model(fileName);
+        baselineFaces = model.OBJIndices.size() / 3;
+    });
+
+    double singleThread = measureFastest(RUNS, [&](){
+        OBJModel model(fileName);
+        faces = model.OBJIndices.size() / 3;
+    });
+
+    double parallel = measureFastest(RUNS, [&](){
+        OBJModel model(fileName, &jobSystem);
+        parallelFaces = model.OBJIndices.size() / 3;
+    });
+
+    remove(fileName.c_str());
+
+    if (baselineFaces != triangles || faces != triangles || parallelFaces != triangles){
+        fprintf(stderr, "Triangle counts differ: %u expected, %u baseline, %u single thread, %u parallel\n",
+                triangles, unsigned(baselineFaces), unsigned(faces), unsigned(parallelFaces));
+        return 1;
+    }
+
+    printf("Parsing\n");
+    printResult("getline and SplitString", baseline, triangles);
+    printResult("memory mapped, one thread", singleThread, triangles);
+    printf("  %-40s %10u\n", "job system threads", jobSystem.getWorkerCount() + 1);
+    printResult("memory mapped, job system", parallel, triangles);
+    printSpeedup("one thread speedup", baseline, singleThread);
+    printSpeedup("job system speedup", baseline, parallel);
+
+    return 0;
+}
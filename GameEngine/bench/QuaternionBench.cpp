@@ -0,0 +1,229 @@
+// Accuracy and throughput of the quaternion interpolation, normalization and
+// batch operations, against a double precision reference and the per quaternion
+// functions they are meant to replace in loops.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/QuaternionBench.cpp math/*.cpp core/JobSystem.cpp
+//         util/MeasurementUnits.cpp util/Timer.cpp -o quaternion_bench
+//
+// Usage: quaternion_bench [quaternion count, 100000 by default]
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "Bench.h"
+#include "../math/Quaternion.h"
+
+static const unsigned RUNS = 10;
+
+// Slerp along the shortest path, in double precision.
+static void referenceSlerp(const Quaternion& from, const Quaternion& to, double t, double result[4]){
+    double a[4] = { from.w, from.x, from.y, from.z };
+    double b[4] = { to.w, to.x, to.y, to.z };
+
+    double cosAngle = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    if (cosAngle < 0){
+        cosAngle = -cosAngle;
+        for (unsigned i = 0; i < 4; i++)
+            b[i] = -b[i];
+    }
+
+    double fromWeight = 1 - t;
+    double toWeight = t;
+    if (cosAngle < 1){
+        double angle = std::acos(std::min(cosAngle, 1.0));
+        double sinAngle = std::sin(angle);
+        if (sinAngle > 0){
+            fromWeight = std::sin((1 - t) * angle) / sinAngle;
+            toWeight = std::sin(t * angle) / sinAngle;
+        }
+    }
+
+    for (unsigned i = 0; i < 4; i++)
+        result[i] = fromWeight * a[i] + toWeight * b[i];
+}
+
+// The largest component difference, up to the sign of the whole quaternion,
+// since q and -q are the same rotation.
+static double difference(const Quaternion& q, const double reference[4]){
+    double same = std::max(std::max(std::fabs(q.w - reference[0]), std::fabs(q.x - reference[1])),
+                           std::max(std::fabs(q.y - reference[2]), std::fabs(q.z - reference[3])));
+    double negated = std::max(std::max(std::fabs(q.w + reference[0]), std::fabs(q.x + reference[1])),
+                              std::max(std::fabs(q.y + reference[2]), std::fabs(q.z + reference[3])));
+    return std::min(same, negated);
+}
+
+// The angle between the rotations of two unit quaternions, in degrees.
+static double angleBetween(const Quaternion& a, const Quaternion& b){
+    double cosHalfAngle = std::min(1.0, std::fabs(double(a.dot(b))));
+    return 2 * std::acos(cosHalfAngle) * 180 / 3.14159265358979323846;
+}
+
+static Quaternion randomUnitQuaternion(std::mt19937& random){
+    std::normal_distribution<float> distribution;
+    Quaternion q(distribution(random), distribution(random), distribution(random), distribution(random));
+    q.normalize();
+    return q;
+}
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    printf("%u quaternions\n", count);
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> nearOne(0.99f, 1.01f);
+
+    std::vector<Quaternion> from(count), to(count), result(count);
+    std::vector<Quaternion> unnormalized(count), normalized(count);
+    std::vector<Matrix4> matrices(count);
+
+    for (unsigned i = 0; i < count; i++){
+        from[i] = randomUnitQuaternion(random);
+        to[i] = randomUnitQuaternion(random);
+
+        // Quaternions drift slightly off unit length as rotations are accumulated.
+        float scale = nearOne(random);
+        Quaternion q = randomUnitQuaternion(random);
+        unnormalized[i] = Quaternion(q.w * scale, q.x * scale, q.y * scale, q.z * scale);
+    }
+
+    const float t = 0.3f;
+
+    printf("Accuracy, largest error\n");
+
+    double fastNormalizeError = 0, fastNormalizeLength = 0;
+    for (unsigned i = 0; i < count; i++){
+        Quaternion exact = unnormalized[i];
+        exact.normalize();
+        Quaternion fast = unnormalized[i];
+        fast.fastNormalize();
+
+        double reference[4] = { exact.w, exact.x, exact.y, exact.z };
+        fastNormalizeError = std::max(fastNormalizeError, difference(fast, reference));
+        fastNormalizeLength = std::max(fastNormalizeLength, std::fabs(1 - double(fast.magnitude())));
+    }
+    printf("  %-40s %10.2g\n", "fastNormalize vs normalize, component", fastNormalizeError);
+    printf("  %-40s %10.2g\n", "fastNormalize, distance to unit length", fastNormalizeLength);
+
+    // Rotations a few degrees away from 'from', on both sides of where slerp falls back on nlerp.
+    std::vector<Quaternion> nearby(count), nearbyResult(count);
+    std::uniform_real_distribution<float> smallAngle(0, 8);
+    for (unsigned i = 0; i < count; i++){
+        nearby[i] = from[i] * Quaternion(Degrees(smallAngle(random)), Vector3(0.6f, 0, 0.8f));
+        nearby[i].normalize();
+    }
+
+    Quaternion::slerp(from.data(), to.data(), t, result.data(), count);
+    Quaternion::slerp(from.data(), nearby.data(), t, nearbyResult.data(), count);
+
+    double slerpError = 0, batchSlerpError = 0, nearbyBatchSlerpError = 0, nlerpAngle = 0;
+    for (unsigned i = 0; i < count; i++){
+        double reference[4];
+        referenceSlerp(from[i], to[i], t, reference);
+
+        Quaternion slerped = Quaternion::slerp(from[i], to[i], t);
+        slerpError = std::max(slerpError, difference(slerped, reference));
+        batchSlerpError = std::max(batchSlerpError, difference(result[i], reference));
+        nlerpAngle = std::max(nlerpAngle, angleBetween(Quaternion::nlerp(from[i], to[i], t), slerped));
+
+        referenceSlerp(from[i], nearby[i], t, reference);
+        nearbyBatchSlerpError = std::max(nearbyBatchSlerpError, difference(nearbyResult[i], reference));
+    }
+    printf("  %-40s %10.2g\n", "slerp vs double precision, component", slerpError);
+    printf("  %-40s %10.2g\n", "batch slerp vs double precision", batchSlerpError);
+    printf("  %-40s %10.2g\n", "batch slerp, nearby rotations", nearbyBatchSlerpError);
+    printf("  %-40s %10.2g\n", "nlerp vs slerp, degrees", nlerpAngle);
+
+    double normalizeLoop = measureFastest(RUNS, [&](){
+        std::copy(unnormalized.begin(), unnormalized.end(), normalized.begin());
+        for (Quaternion& q : normalized)
+            q.normalize();
+        keepValue(normalized[count / 2]);
+    });
+
+    double fastNormalizeBatch = measureFastest(RUNS, [&](){
+        std::copy(unnormalized.begin(), unnormalized.end(), normalized.begin());
+        Quaternion::fastNormalize(normalized.data(), count);
+        keepValue(normalized[count / 2]);
+    });
+
+    double slerpLoop = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            result[i] = Quaternion::slerp(from[i], to[i], t);
+        keepValue(result[count / 2]);
+    });
+
+    double slerpBatch = measureFastest(RUNS, [&](){
+        Quaternion::slerp(from.data(), to.data(), t, result.data(), count);
+        keepValue(result[count / 2]);
+    });
+
+    double nlerpLoop = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            result[i] = Quaternion::nlerp(from[i], to[i], t);
+        keepValue(result[count / 2]);
+    });
+
+    double nlerpBatch = measureFastest(RUNS, [&](){
+        Quaternion::nlerp(from.data(), to.data(), t, result.data(), count);
+        keepValue(result[count / 2]);
+    });
+
+    double toMatrixLoop = measureFastest(RUNS, [&](){
+        for (unsigned i = 0; i < count; i++)
+            matrices[i] = from[i].toMatrix();
+        keepValue(matrices[count / 2]);
+    });
+
+    double toMatricesBatch = measureFastest(RUNS, [&](){
+        Quaternion::toMatrices(from.data(), matrices.data(), count);
+        keepValue(matrices[count / 2]);
+    });
+
+    double separateAxes = measureFastest(RUNS, [&](){
+        float sum = 0;
+        for (const Quaternion& q : from)
+            sum += q.getForward().x + q.getUp().y + q.getRight().z;
+        keepValue(sum);
+    });
+
+    double basis = measureFastest(RUNS, [&](){
+        float sum = 0;
+        for (const Quaternion& q : from){
+            QuaternionBasis axes = q.getBasis();
+            sum += axes.forward.x + axes.up.y + axes.right.z;
+        }
+        keepValue(sum);
+    });
+
+    printf("Normalize\n");
+    printResult("normalize, per quaternion", normalizeLoop, count);
+    printResult("fastNormalize, batch", fastNormalizeBatch, count);
+    printSpeedup("speedup", normalizeLoop, fastNormalizeBatch);
+
+    printf("Slerp\n");
+    printResult("per quaternion", slerpLoop, count);
+    printResult("batch", slerpBatch, count);
+    printSpeedup("speedup", slerpLoop, slerpBatch);
+
+    printf("Nlerp\n");
+    printResult("per quaternion", nlerpLoop, count);
+    printResult("batch", nlerpBatch, count);
+    printSpeedup("speedup", nlerpLoop, nlerpBatch);
+    printSpeedup("batch nlerp over batch slerp", slerpBatch, nlerpBatch);
+
+    printf("To matrix\n");
+    printResult("toMatrix, per quaternion", toMatrixLoop, count);
+    printResult("toMatrices, batch", toMatricesBatch, count);
+    printSpeedup("speedup", toMatrixLoop, toMatricesBatch);
+
+    printf("Axes\n");
+    printResult("getForward, getUp and getRight", separateAxes, count);
+    printResult("getBasis", basis, count);
+    printSpeedup("speedup", separateAxes, basis);
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Vertex array throughput of the plain Vector3, against the layout it replaced,
+// which kept references to its own components next to them.
+//
+//     g++ -std=c++11 -O2 -pthread -I. -Imath -Iutil bench/VertexArrayBench.cpp math/Vector3.cpp
+//         math/Vector.cpp math/Vector4.cpp util/Timer.cpp -o vertex_array_bench
+//
+// Usage: vertex_array_bench [vertex count, 1000000 by default]
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Bench.h"
+#include "../math/Vector3.h"
+
+// The old Vector3: the references make it 40 bytes instead of 12, and need a
+// custom copy so they do not point into the copied vector.
+class ReferenceVector3
+{
+public:
+    ReferenceVector3() : x(components[0]), y(components[1]), z(components[2]){
+        x = y = z = 0;
+    }
+
+    ReferenceVector3(float x, float y, float z) : x(components[0]), y(components[1]), z(components[2]){
+        this->x = x;
+        this->y = y;
+        this->z = z;
+    }
+
+    ReferenceVector3(const ReferenceVector3& other) : x(components[0]), y(components[1]), z(components[2]){
+        for (unsigned i = 0; i < 3; i++)
+            components[i] = other.components[i];
+    }
+
+    ReferenceVector3& operator=(const ReferenceVector3& other){
+        for (unsigned i = 0; i < 3; i++)
+            components[i] = other.components[i];
+        return *this;
+    }
+
+    float components[3];
+
+    float& x;
+    float& y;
+    float& z;
+};
+
+static const unsigned RUNS = 10;
+
+int main(int argc, char** argv){
+
+    unsigned count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    printf("%u vertices, %u bytes each before, %u after\n", count,
+           unsigned(sizeof(ReferenceVector3)), unsigned(sizeof(Vector3)));
+
+    std::vector<ReferenceVector3> referencePositions;
+    std::vector<Vector3> positions;
+    for (unsigned i = 0; i < count; i++){
+        referencePositions.push_back(ReferenceVector3(float(i), float(i % 7), float(i % 13)));
+        positions.push_back(Vector3(float(i), float(i % 7), float(i % 13)));
+    }
+
+    std::vector<float> uploadBuffer(count * 3);
+
+    // What a buffer upload has to do: the old layout has to be packed into floats
+    // first, the new one is already packed.
+    double referenceUpload = measureFastest(RUNS, [&](){
+        float* packed = uploadBuffer.data();
+        for (const ReferenceVector3& position : referencePositions){
+            *packed++ = position.x;
+            *packed++ = position.y;
+            *packed++ = position.z;
+        }
+        keepValue(uploadBuffer[count]);
+    });
+
+    double upload = measureFastest(RUNS, [&](){
+        memcpy(uploadBuffer.data(), positions.data(), positions.size() * sizeof(Vector3));
+        keepValue(uploadBuffer[count]);
+    });
+
+    // Copying the array, e.g. when a model is cooked or cached.
+    double referenceCopy = measureFastest(RUNS, [&](){
+        std::vector<ReferenceVector3> copy(referencePositions);
+        keepValue(copy[count / 2].components[0]);
+    });
+
+    double copy = measureFastest(RUNS, [&](){
+        std::vector<Vector3> copy(positions);
+        keepValue(copy[count / 2].x);
+    });
+
+    // Offsetting every vertex in place. Both versions share the arithmetic operators
+    // of Vector, so the components are updated directly to only measure the layout.
+    double referenceOffsetting = measureFastest(RUNS, [&](){
+        for (ReferenceVector3& position : referencePositions){
+            position.x += 1;
+            position.y += 2;
+            position.z += 3;
+        }
+        keepValue(referencePositions[count / 2].components[0]);
+    });
+
+    double offsetting = measureFastest(RUNS, [&](){
+        for (Vector3& position : positions){
+            position.x += 1;
+            position.y += 2;
+            position.z += 3;
+        }
+        keepValue(positions[count / 2].x);
+    });
+
+    printf("Packing for upload\n");
+    printResult("reference members, packed per vertex", referenceUpload, count);
+    printResult("plain, memcpy", upload, count);
+    printSpeedup("speedup", referenceUpload, upload);
+
+    printf("Copying the array\n");
+    printResult("reference members", referenceCopy, count);
+    printResult("plain", copy, count);
+    printSpeedup("speedup", referenceCopy, copy);
+
+    printf("Offsetting in place\n");
+    printResult("reference members", referenceOffsetting, count);
+    printResult("plain", offsetting, count);
+    printSpeedup("speedup", referenceOffsetting, offsetting);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+// The source has been obtained from https://github.com/BennyQBD/ModernOpenGLTutorial.
+// The code has been modified to work with Cor's math classes
+
+// The OBJ loader as it was before the memory mapped parser and the hashed vertex
+// deduplication, renamed so it links next to the current one. Only kept as the
+// reference of the loader benchmark and the indexing test.
+
+#ifndef BASELINEOBJMODEL_H
+#define BASELINEOBJMODEL_H
+
+#include <vector>
+#include <string>
+
+#include "../../math/Vector3.h"
+#include "../../math/Vector2.h"
+
+struct BaselineOBJIndex
+{
+    unsigned int vertexIndex;
+    unsigned int uvIndex;
+    unsigned int normalIndex;
+
+    bool operator<(const BaselineOBJIndex& r) const { return vertexIndex < r.vertexIndex; }
+};
+
+class BaselineIndexedModel
+{
+public:
+    std::vector<Vector3> positions;
+    std::vector<Vector2> texCoords;
+    std::vector<Vector3> normals;
+    std::vector<unsigned int> indices;
+
+    void CalcNormals();
+};
+
+class BaselineOBJModel
+{
+public:
+    std::vector<BaselineOBJIndex> OBJIndices;
+    std::vector<Vector3> vertices;
+    std::vector<Vector2> uvs;
+    std::vector<Vector3> normals;
+    bool hasUVs;
+    bool hasNormals;
+
+    BaselineOBJModel(const std::string& fileName);
+
+    BaselineIndexedModel ToIndexedModel();
+
+private:
+    unsigned int FindLastVertexIndex(const std::vector<BaselineOBJIndex*>& indexLookup, const BaselineOBJIndex* currentIndex, const BaselineIndexedModel& result);
+    void CreateOBJFace(const std::string& line);
+
+    Vector2 ParseOBJVec2(const std::string& line);
+    Vector3 ParseOBJVec3(const std::string& line);
+    BaselineOBJIndex ParseOBJIndex(const std::string& token, bool* hasUVs, bool* hasNormals);
+};
+
+#endif // BASELINEOBJMODEL_H
@@ -0,0 +1,72 @@
+// The component manager as it was before the packed pools: every component is
+// allocated on its own and found through one multimap keyed by entity and type.
+// Only kept as the reference of the component benchmarks.
+
+#ifndef MULTIMAPCOMPONENTMANAGER_H
+#define MULTIMAPCOMPONENTMANAGER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <typeindex>
+
+#include "../../components/Component.h"
+
+using std::unordered_multimap;
+using std::unordered_map;
+
+class MultimapComponentManager
+{
+public:
+    ~MultimapComponentManager(){
+        for (auto& iter : components)
+            delete iter.second;
+    }
+
+    template<typename T>
+    T* addComponent(unsigned entityId){
+        T* newComponent = new T(entityId);
+        components.insert(std::make_pair(getMaskKey(entityId, getComponentTypeId(typeid(T))), newComponent));
+        return newComponent;
+    }
+
+    template<typename T>
+    T* getComponent(unsigned entityId) const{
+        auto mapItr = components.find(getMaskKey(entityId, getComponentTypeId(typeid(T))));
+        if (mapItr != components.end())
+            return static_cast<T*>(mapItr->second);
+
+        return nullptr;
+    }
+
+    // The original had no way to remove a component. This is the obvious one,
+    // for the spawn and despawn benchmark.
+    template<typename T>
+    void removeComponent(unsigned entityId){
+        auto mapItr = components.find(getMaskKey(entityId, getComponentTypeId(typeid(T))));
+        if (mapItr != components.end()){
+            delete mapItr->second;
+            components.erase(mapItr);
+        }
+    }
+
+private:
+
+    unsigned getComponentTypeId(const std::type_index& typeIndex) const{
+        auto mapItr = componentTypeIds.find(typeIndex);
+        if (mapItr != componentTypeIds.end())
+            return mapItr->second;
+
+        unsigned typeId = typeIndex.hash_code();
+        componentTypeIds.insert(std::make_pair(typeIndex, typeId));
+        return typeId;
+    }
+
+    uint64_t getMaskKey(unsigned entityId, unsigned componentTypeId) const{
+        return (uint64_t(entityId) << 32) | componentTypeId;
+    }
+
+    mutable unordered_map<std::type_index, unsigned> componentTypeIds;
+    unordered_multimap<uint64_t, Component*> components;
+};
+
+#endif // MULTIMAPCOMPONENTMANAGER_H
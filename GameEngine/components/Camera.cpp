@@ -190,6 +190,19 @@ float Camera::getHeight() const{
     return height;
 }
 
+float Camera::getProjectedSize(float length, float distance, float viewportHeight) const{
+
+    // The view is the same size at every distance.
+    if (cameraView == ORTHO)
+        return length * viewportHeight / height;
+
+    // Nothing is drawn closer than the near plane.
+    if (distance < zNear)
+        distance = zNear;
+
+    return length * viewportHeight / (2 * distance * tanFOV);
+}
+
 const Camera::ViewType& Camera::getViewType() const{
     return cameraView;
 }
@@ -44,6 +44,10 @@ public:
     float getWidth() const;
     float getHeight() const;
 
+    // How many pixels a length in the world covers at the distance from the camera,
+    // on a viewport this many pixels tall. Used to pick levels of detail.
+    float getProjectedSize(float length, float distance, float viewportHeight) const;
+
     const enum ViewType& getViewType() const;
 
 private:
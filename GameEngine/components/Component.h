@@ -15,7 +15,8 @@ protected:
 
     // The entity which this components belongs to.
     // Used to associate groups of components to an entity.
-    const unsigned entityId;
+    // Not const so components can be moved around inside their pool.
+    unsigned entityId;
 };
 
 #endif // COMPONENT_H
@@ -1,4 +1,5 @@
 #include "ComponentManager.h"
+#include "../entity/EntityId.h"
 
 ComponentManager::ComponentManager()
 {
@@ -6,33 +7,91 @@ ComponentManager::ComponentManager()
 }
 
 ComponentManager::~ComponentManager(){
-    for(auto& iter : components){
-        delete iter.second;
+    for(BaseComponentPool* pool : pools){
+        delete pool;
     }
 }
 
-unsigned ComponentManager::getComponentTypeId(const std::type_index& typeIndex) const{
+const ComponentSignature& ComponentManager::getSignature(unsigned entityId) const{
 
-    auto mapItr = componentTypeIds.find(typeIndex);
+    // Entities that never had a component own nothing.
+    static const ComponentSignature empty;
 
-    // Component already registered
-    if (mapItr != componentTypeIds.end()){
-        return mapItr->second;
+    unsigned entityIndex = getEntityIndex(entityId);
+    if (entityIndex >= signatures.size())
+        return empty;
+
+    return signatures[entityIndex];
+}
+
+void ComponentManager::removeComponent(unsigned componentTypeId, unsigned entityId){
+    if (!isCurrent(entityId) || componentTypeId >= pools.size() || !pools[componentTypeId])
+        return;
+
+    if (pools[componentTypeId]->has(entityId)){
+        pools[componentTypeId]->remove(entityId);
+        setSignatureBit(entityId, componentTypeId, false);
+    }
+}
+
+void ComponentManager::removeAllComponents(const unsigned* entityIds, unsigned count){
+
+    // Collect every component type owned by any of the entities.
+    ComponentSignature owned;
+    for (unsigned i = 0; i < count; i++)
+        owned |= getSignature(entityIds[i]);
+
+    for (unsigned typeId = 0; typeId < pools.size(); typeId++){
+        if (!owned.test(typeId))
+            continue;
+
+        for (unsigned i = 0; i < count; i++)
+            pools[typeId]->remove(entityIds[i]);
     }
 
-    // Component type not yet registered in the manager
-    else{
-        unsigned typeId = typeIndex.hash_code();
+    // The ids are stale from now on.
+    for (unsigned i = 0; i < count; i++){
+        unsigned entityIndex = getEntityIndex(entityIds[i]);
+        if (entityIndex >= signatures.size()){
+            signatures.resize(entityIndex + 1);
+            generations.resize(entityIndex + 1, 0);
+        }
 
-        std::pair<std::type_index, unsigned> pair(typeIndex, typeId);
-        componentTypeIds.insert(pair);
-        return typeId;
+        signatures[entityIndex].reset();
+        generations[entityIndex] = (getEntityGeneration(entityIds[i]) + 1) & ENTITY_GENERATION_MASK;
     }
 }
 
-uint64_t ComponentManager::getMaskKey(unsigned entityId, unsigned componentTypeId) const{
-    uint64_t mask = 0;
-    mask = (mask | entityId) << 32;
-    mask |= componentTypeId;
-    return mask;
+AllocatorStats ComponentManager::getStats() const{
+    AllocatorStats stats;
+    for (const BaseComponentPool* pool : pools)
+        if (pool)
+            stats += pool->getStats();
+    return stats;
+}
+
+void ComponentManager::shrink(){
+    for (BaseComponentPool* pool : pools)
+        if (pool)
+            pool->shrink();
+}
+
+bool ComponentManager::isCurrent(unsigned entityId) const{
+    if (entityId == INVALID_ENTITY)
+        return false;
+
+    // Indices never destroyed are still on their first generation.
+    unsigned entityIndex = getEntityIndex(entityId);
+    unsigned generation = entityIndex < generations.size() ? generations[entityIndex] : 0;
+    return getEntityGeneration(entityId) == generation;
+}
+
+void ComponentManager::setSignatureBit(unsigned entityId, unsigned componentTypeId, bool value){
+    unsigned entityIndex = getEntityIndex(entityId);
+    if (entityIndex >= signatures.size()){
+        signatures.resize(entityIndex + 1);
+        generations.resize(entityIndex + 1, 0);
+    }
+
+    signatures[entityIndex].set(componentTypeId, value);
 }
@@ -2,13 +2,15 @@
 #define COMPONENTMANAGER_H
 
 #include <iostream>
-#include <unordered_map>
-#include <typeindex>
+#include <vector>
+#include <cassert>
 
 #include "Component.h"
+#include "ComponentType.h"
+#include "ComponentPool.h"
+#include "ComponentView.h"
 
-using std::unordered_multimap;
-using std::unordered_map;
+using std::vector;
 
 class ComponentManager
 {
@@ -16,56 +18,140 @@ public:
     ComponentManager();
     ~ComponentManager();
 
+    // Components live packed in their type's pool. The returned pointer is only
+    // valid until components of the same type are added or removed.
+    // Returns nullptr for the stale id of a destroyed entity.
     template<typename T>
     T* addComponent(unsigned entityId);
 
     template<typename T>
     T* getComponent(unsigned entityId) const;
 
+    template<typename T>
+    void removeComponent(unsigned entityId);
+
+    // Removes a component by the id of its type (see ComponentType).
+    // Stale ids of destroyed entities are ignored.
+    void removeComponent(unsigned componentTypeId, unsigned entityId);
+
+    template<typename T>
+    bool hasComponent(unsigned entityId) const;
+
+    // Removes every component owned by the entities.
+    // Pools are visited one at a time to remove all the entities from each.
+    void removeAllComponents(const unsigned* entityIds, unsigned count);
+
+    // The memory used by all component pools together.
+    AllocatorStats getStats() const;
+
+    // Gives the memory of unused component chunks back to the system.
+    void shrink();
+
+    // The set of component types owned by a live entity.
+    const ComponentSignature& getSignature(unsigned entityId) const;
+
+    // Obtain the packed storage of a component type in order to sweep it linearly.
+    template<typename T>
+    ComponentPool<T>& getPool();
+
+    // Obtain a view of every entity that owns all of the component types.
+    // Example: view<Transform, Mesh>().each([](unsigned id, Transform& t, Mesh& m){ ... });
+    template<typename... Types>
+    ComponentView<Types...> view() const;
+
 private:
 
-    unsigned getComponentTypeId(const std::type_index&) const;
-    uint64_t getMaskKey(unsigned entityId, unsigned componentTypeId) const;
+    template<typename T>
+    ComponentPool<T>* findPool() const;
+
+    // Returns false for ids of destroyed entities, whose index may now belong to
+    // a newer entity.
+    bool isCurrent(unsigned entityId) const;
+
+    void setSignatureBit(unsigned entityId, unsigned componentTypeId, bool value);
+
+    // Stores one pool of components per component type, indexed by the type id.
+    vector<BaseComponentPool*> pools;
 
-    // Stores the integer representation of the component type.
-    // Used to add and query for a component.
-    mutable unordered_map<std::type_index, unsigned> componentTypeIds;
+    // Stores the component signature of each entity, indexed by the entity index.
+    vector<ComponentSignature> signatures;
 
-    // Stores all the components.
-    // It also associates an entity to the component.
-    unordered_multimap <uint64_t, Component*> components;
+    // The generation of the entity that owns each signature. Once an entity is
+    // destroyed it is the next generation, the one the entity manager hands out
+    // when it recycles the index (see EntityId.h).
+    vector<unsigned> generations;
 };
 
 template<typename T>
 T* ComponentManager::addComponent(unsigned entityId){
 
-    // Create a new component and a mask to associate the entity and component type.
-    T* newComponent = new T(entityId);
-    unsigned componentTypeId = getComponentTypeId(typeid(T));
-    uint64_t mask = getMaskKey(entityId, componentTypeId);
+    // A stale id would take the index of the entity that reused it.
+    if (!isCurrent(entityId))
+        return nullptr;
+
+    T* component = getPool<T>().add(entityId);
+    if (!component)
+        return nullptr;
 
-    // Insert the new component into the map.
-    std::pair<uint64_t, Component*> pair(mask, newComponent);
-    components.insert(pair);
-    return newComponent;
+    setSignatureBit(entityId, ComponentType::getId<T>(), true);
+    return component;
 }
 
 template <typename T>
 T* ComponentManager::getComponent(unsigned entityId) const{
 
-    unsigned componentTypeId = getComponentTypeId(typeid(T));
-    uint64_t mask = getMaskKey(entityId, componentTypeId);
+    ComponentPool<T>* pool = findPool<T>();
+
+    // No component of this type was ever added.
+    if (!pool)
+        return nullptr;
+
+    return pool->get(entityId);
+}
+
+template<typename T>
+void ComponentManager::removeComponent(unsigned entityId){
+    removeComponent(ComponentType::getId<T>(), entityId);
+}
+
+template<typename T>
+bool ComponentManager::hasComponent(unsigned entityId) const{
+
+    // Ask the pool, since it also checks the generation of the id.
+    ComponentPool<T>* pool = findPool<T>();
+    return pool && pool->has(entityId);
+}
+
+template<typename T>
+ComponentPool<T>& ComponentManager::getPool(){
 
-    // Find the mask key in the dictionary and return the component if it exists.
-    auto mapItr = components.find(mask);
-    if (mapItr != components.end()){
-        return static_cast<T*>(mapItr->second);
-    }
+    unsigned componentTypeId = ComponentType::getId<T>();
+    assert(componentTypeId < MAX_COMPONENT_TYPES);
+
+    if (componentTypeId >= pools.size())
+        pools.resize(componentTypeId + 1, nullptr);
+
+    // Component type not yet registered in the manager
+    if (!pools[componentTypeId])
+        pools[componentTypeId] = new ComponentPool<T>();
+
+    return *static_cast<ComponentPool<T>*>(pools[componentTypeId]);
+}
+
+template<typename... Types>
+ComponentView<Types...> ComponentManager::view() const{
+    return ComponentView<Types...>(findPool<Types>()...);
+}
+
+template<typename T>
+ComponentPool<T>* ComponentManager::findPool() const{
+
+    unsigned componentTypeId = ComponentType::getId<T>();
+    if (componentTypeId < pools.size())
+        return static_cast<ComponentPool<T>*>(pools[componentTypeId]);
 
     // Not found
-    else{
-        return nullptr;
-    }
+    return nullptr;
 }
 
 #endif // COMPONENTMANAGER_H
@@ -0,0 +1,77 @@
+#include "ComponentPool.h"
+#include "../entity/EntityId.h"
+
+const unsigned BaseComponentPool::INVALID_INDEX;
+
+BaseComponentPool::BaseComponentPool() : version(0)
+{
+    //ctor
+}
+
+BaseComponentPool::~BaseComponentPool()
+{
+    //dtor
+}
+
+bool BaseComponentPool::has(unsigned entityId) const{
+    return indexOf(entityId) != INVALID_INDEX;
+}
+
+unsigned BaseComponentPool::size() const{
+    return packed.size();
+}
+
+const vector<unsigned>& BaseComponentPool::getEntities() const{
+    return packed;
+}
+
+unsigned BaseComponentPool::getVersion() const{
+    return version;
+}
+
+unsigned BaseComponentPool::indexOf(unsigned entityId) const{
+
+    unsigned entityIndex = getEntityIndex(entityId);
+    if (entityIndex >= sparse.size())
+        return INVALID_INDEX;
+
+    // The slot may belong to an entity that reused the index (a newer generation).
+    unsigned index = sparse[entityIndex];
+    if (index == INVALID_INDEX || packed[index] != entityId)
+        return INVALID_INDEX;
+
+    return index;
+}
+
+bool BaseComponentPool::isIndexTaken(unsigned entityId) const{
+    unsigned entityIndex = getEntityIndex(entityId);
+    return entityIndex < sparse.size() && sparse[entityIndex] != INVALID_INDEX;
+}
+
+unsigned BaseComponentPool::insertEntity(unsigned entityId){
+
+    // Grow the sparse array so it can be indexed by the entity index.
+    unsigned entityIndex = getEntityIndex(entityId);
+    if (entityIndex >= sparse.size())
+        sparse.resize(entityIndex + 1, INVALID_INDEX);
+
+    unsigned index = packed.size();
+    sparse[entityIndex] = index;
+    packed.push_back(entityId);
+    version++;
+    return index;
+}
+
+void BaseComponentPool::eraseEntity(unsigned entityId){
+
+    unsigned index = sparse[getEntityIndex(entityId)];
+    unsigned last = packed.back();
+
+    // Mirror the swap done on the component array.
+    packed[index] = last;
+    sparse[getEntityIndex(last)] = index;
+
+    packed.pop_back();
+    sparse[getEntityIndex(entityId)] = INVALID_INDEX;
+    version++;
+}
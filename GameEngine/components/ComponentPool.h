@@ -0,0 +1,258 @@
+#ifndef COMPONENTPOOL_H
+#define COMPONENTPOOL_H
+
+#include <vector>
+#include <utility>
+#include <new>
+
+#include "../util/ChunkAllocator.h"
+
+using std::vector;
+
+// How the components of a type are laid out in memory.
+// Specialize it for a component type to change its chunk size or alignment.
+template<typename T>
+struct ComponentStorageTraits{
+
+    // The number of bytes of each block of components.
+    static const unsigned CHUNK_SIZE = 16 * 1024;
+
+    // Chunks start on a cache line by default.
+    static const unsigned ALIGNMENT = alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE;
+};
+
+// Returns the largest power of two count of elements that fit in the chunk size.
+constexpr unsigned elementsPerChunk(unsigned elementSize, unsigned chunkSize, unsigned count = 1){
+    return count * 2 * elementSize <= chunkSize ? elementsPerChunk(elementSize, chunkSize, count * 2) : count;
+}
+
+// Returns the base 2 logarithm of a power of two.
+constexpr unsigned log2PowerOfTwo(unsigned value){
+    return value <= 1 ? 0 : 1 + log2PowerOfTwo(value / 2);
+}
+
+// The type independent part of a component pool.
+// A pool is a sparse set: the sparse array maps an entity index to a slot in the
+// packed arrays, and the packed arrays keep the components (and their owners)
+// contiguous so they can be swept linearly.
+class BaseComponentPool
+{
+public:
+    BaseComponentPool();
+    virtual ~BaseComponentPool();
+
+    // Returns true if the entity owns a component in this pool.
+    bool has(unsigned entityId) const;
+
+    // Removes the component of the entity if it owns one.
+    virtual void remove(unsigned entityId) = 0;
+
+    // Memory used by the pool's components.
+    virtual AllocatorStats getStats() const = 0;
+
+    // Gives the memory of unused chunks back to the system.
+    virtual void shrink() = 0;
+
+    // The number of components packed in the pool.
+    unsigned size() const;
+
+    // The owners of the packed components, in the same order as the components.
+    const vector<unsigned>& getEntities() const;
+
+    // Returns the packed slot of the entity, or INVALID_INDEX.
+    unsigned indexOf(unsigned entityId) const;
+
+    // Returns true if any generation of the entity's index owns a component.
+    bool isIndexTaken(unsigned entityId) const;
+
+    // Changes whenever a component is added or removed, i.e. whenever packed
+    // slots may refer to other entities. Lets systems keep data per slot.
+    unsigned getVersion() const;
+
+    // Marks a sparse entry of an entity that has no component in the pool.
+    static const unsigned INVALID_INDEX = 0xFFFFFFFF;
+
+protected:
+
+    // Appends the entity to the packed entities and returns its slot.
+    unsigned insertEntity(unsigned entityId);
+
+    // Moves the last packed entity into the slot of the removed one.
+    // The component array must be compacted the same way by the caller.
+    void eraseEntity(unsigned entityId);
+
+    // Entity index -> packed slot.
+    vector<unsigned> sparse;
+
+    // Packed slot -> entity id.
+    vector<unsigned> packed;
+
+    unsigned version;
+};
+
+// Holds every component of type T packed in fixed-size chunks.
+// Chunks come from a per-type chunk allocator, so components never move when
+// the pool grows. Removing a component moves the last one into its slot, so
+// pointers to the last component are invalidated by a remove.
+template<typename T>
+class ComponentPool : public BaseComponentPool
+{
+public:
+    ComponentPool();
+    ~ComponentPool();
+
+    // Creates a component for the entity. An entity can only own one
+    // component of each type, so the existing one is returned if present.
+    // Returns nullptr if another generation of the entity still owns one.
+    T* add(unsigned entityId);
+
+    T* get(unsigned entityId) const;
+
+    void remove(unsigned entityId);
+
+    AllocatorStats getStats() const;
+    void shrink();
+
+    // Access a component by its packed slot.
+    T& operator[](unsigned index) const;
+
+    // Linear access to the packed components, one chunk at a time.
+    unsigned getChunkCount() const;
+    T* getChunk(unsigned chunk) const;
+    unsigned getChunkLength(unsigned chunk) const;
+
+    // The number of components held by each chunk. Always a power of two.
+    static const unsigned COMPONENTS_PER_CHUNK = elementsPerChunk(sizeof(T), ComponentStorageTraits<T>::CHUNK_SIZE);
+    static const unsigned CHUNK_SHIFT = log2PowerOfTwo(COMPONENTS_PER_CHUNK);
+
+private:
+    ComponentPool(const ComponentPool&) = delete;
+    ComponentPool& operator=(const ComponentPool&) = delete;
+
+    // Returns the memory location of the packed slot.
+    T* slot(unsigned index) const;
+
+    ChunkAllocator allocator;
+    vector<T*> chunks;
+};
+
+template<typename T>
+const unsigned ComponentPool<T>::COMPONENTS_PER_CHUNK;
+
+template<typename T>
+const unsigned ComponentPool<T>::CHUNK_SHIFT;
+
+template<typename T>
+ComponentPool<T>::ComponentPool() :
+    allocator(COMPONENTS_PER_CHUNK * sizeof(T), ComponentStorageTraits<T>::ALIGNMENT)
+{}
+
+template<typename T>
+ComponentPool<T>::~ComponentPool(){
+    for (unsigned i = 0; i < size(); i++)
+        slot(i)->~T();
+
+    // The allocator frees the chunks themselves.
+}
+
+template<typename T>
+T* ComponentPool<T>::add(unsigned entityId){
+
+    unsigned index = indexOf(entityId);
+    if (index != INVALID_INDEX)
+        return slot(index);
+
+    if (isIndexTaken(entityId))
+        return nullptr;
+
+    index = size();
+
+    // All chunks are full
+    if (index == chunks.size() * COMPONENTS_PER_CHUNK)
+        chunks.push_back(static_cast<T*>(allocator.allocate()));
+
+    T* component = new (slot(index)) T(entityId);
+    insertEntity(entityId);
+    return component;
+}
+
+template<typename T>
+T* ComponentPool<T>::get(unsigned entityId) const{
+
+    unsigned index = indexOf(entityId);
+    if (index == INVALID_INDEX)
+        return nullptr;
+
+    return slot(index);
+}
+
+template<typename T>
+void ComponentPool<T>::remove(unsigned entityId){
+
+    unsigned index = indexOf(entityId);
+    if (index == INVALID_INDEX)
+        return;
+
+    // Keep the chunks packed by moving the last component into the hole.
+    unsigned last = size() - 1;
+    if (index != last)
+        *slot(index) = std::move(*slot(last));
+
+    slot(last)->~T();
+    eraseEntity(entityId);
+
+    // Give back the last chunk once a whole spare chunk is left before it.
+    // Keeping one spare avoids allocating again when adds and removes alternate.
+    if (chunks.size() * COMPONENTS_PER_CHUNK - size() > COMPONENTS_PER_CHUNK){
+        allocator.deallocate(chunks.back());
+        chunks.pop_back();
+    }
+}
+
+template<typename T>
+AllocatorStats ComponentPool<T>::getStats() const{
+    AllocatorStats stats = allocator.getStats();
+    stats.bytesLive = size() * sizeof(T);
+    return stats;
+}
+
+template<typename T>
+void ComponentPool<T>::shrink(){
+
+    // Drop the spare chunk too if it holds nothing.
+    if (!chunks.empty() && (chunks.size() - 1) * COMPONENTS_PER_CHUNK >= size()){
+        allocator.deallocate(chunks.back());
+        chunks.pop_back();
+    }
+
+    allocator.releaseFreeChunks();
+}
+
+template<typename T>
+T& ComponentPool<T>::operator[](unsigned index) const{
+    return *slot(index);
+}
+
+template<typename T>
+unsigned ComponentPool<T>::getChunkCount() const{
+    return (size() + COMPONENTS_PER_CHUNK - 1) >> CHUNK_SHIFT;
+}
+
+template<typename T>
+T* ComponentPool<T>::getChunk(unsigned chunk) const{
+    return chunks[chunk];
+}
+
+template<typename T>
+unsigned ComponentPool<T>::getChunkLength(unsigned chunk) const{
+    unsigned start = chunk << CHUNK_SHIFT;
+    unsigned remaining = size() - start;
+    return remaining < COMPONENTS_PER_CHUNK ? remaining : COMPONENTS_PER_CHUNK;
+}
+
+template<typename T>
+T* ComponentPool<T>::slot(unsigned index) const{
+    return chunks[index >> CHUNK_SHIFT] + (index & (COMPONENTS_PER_CHUNK - 1));
+}
+
+#endif // COMPONENTPOOL_H
@@ -0,0 +1,3 @@
+#include "ComponentType.h"
+
+std::atomic<unsigned> ComponentType::nextId(0);
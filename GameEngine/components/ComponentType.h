@@ -0,0 +1,53 @@
+#ifndef COMPONENTTYPE_H
+#define COMPONENTTYPE_H
+
+#include <atomic>
+#include <bitset>
+#include <initializer_list>
+
+// The maximum number of different component types the engine can hold.
+constexpr unsigned MAX_COMPONENT_TYPES = 64;
+
+// One bit per component type, set if an entity owns that type of component.
+typedef std::bitset<MAX_COMPONENT_TYPES> ComponentSignature;
+
+// Generates a dense integer id per component type.
+// Each type gets the next id the first time it is asked for, so ids can be
+// used directly as array indices without hashing the type.
+class ComponentType
+{
+public:
+
+    template<typename T>
+    static unsigned getId();
+
+    // Builds the signature that has the bits of all the given types set.
+    template<typename... Types>
+    static ComponentSignature getSignature();
+
+private:
+
+    // The id that the next newly seen component type will get.
+    static std::atomic<unsigned> nextId;
+};
+
+template<typename T>
+unsigned ComponentType::getId(){
+
+    // Initialized only once per type.
+    static const unsigned id = nextId++;
+    return id;
+}
+
+template<typename... Types>
+ComponentSignature ComponentType::getSignature(){
+    ComponentSignature signature;
+    std::initializer_list<unsigned> ids = { getId<Types>()... };
+
+    for (unsigned id : ids)
+        signature.set(id);
+
+    return signature;
+}
+
+#endif // COMPONENTTYPE_H
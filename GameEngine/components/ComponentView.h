@@ -0,0 +1,170 @@
+#ifndef COMPONENTVIEW_H
+#define COMPONENTVIEW_H
+
+#include <tuple>
+
+#include "ComponentPool.h"
+
+// Holds the pool of one of the component types a view iterates.
+// The view inherits one of these per type so pools can be reached by type.
+template<typename T>
+struct ViewPool{
+    ViewPool(ComponentPool<T>* pool) : pool(pool) {}
+    ComponentPool<T>* pool;
+};
+
+// Iterates every entity that owns all of the component types.
+// The smallest pool drives the iteration and the other pools are probed
+// through their sparse arrays, so nothing is allocated per entity.
+// Components must not be added or removed while a view is being iterated.
+template<typename... Types>
+class ComponentView : private ViewPool<Types>...
+{
+public:
+
+    // A missing pool (type never added) results in an empty view.
+    ComponentView(ComponentPool<Types>*... pools);
+
+    class Iterator{
+
+    public:
+        Iterator(const ComponentView* view, unsigned index);
+
+        std::tuple<Types&...> operator*() const;
+        const Iterator& operator++();
+        bool operator!=(const Iterator&) const;
+
+        // The entity that owns the components currently pointed at.
+        unsigned getEntity() const;
+
+    private:
+
+        // Move forward until an entity owning all the types is found.
+        void skipUnmatched();
+
+        const ComponentView* view;
+        unsigned index;
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    // Calls func(entityId, Types&...) for every entity in the view.
+    template<typename Func>
+    void each(Func func) const;
+
+    // Returns true if the entity owns all the component types of the view.
+    bool contains(unsigned entityId) const;
+
+private:
+
+    static const unsigned NUM_TYPES = sizeof...(Types);
+
+    // The pools of all types, to query them without knowing the type.
+    BaseComponentPool* basePools[NUM_TYPES];
+
+    // The smallest pool, which is the one walked by the view.
+    BaseComponentPool* driver;
+};
+
+template<typename... Types>
+ComponentView<Types...>::ComponentView(ComponentPool<Types>*... pools) :
+    ViewPool<Types>(pools)..., driver(nullptr)
+{
+    BaseComponentPool* all[NUM_TYPES] = { pools... };
+
+    for (unsigned i = 0; i < NUM_TYPES; i++){
+        basePools[i] = all[i];
+
+        // Nothing can match if one of the types has no pool.
+        if (!all[i]){
+            driver = nullptr;
+            return;
+        }
+
+        if (!driver || all[i]->size() < driver->size())
+            driver = all[i];
+    }
+}
+
+template<typename... Types>
+bool ComponentView<Types...>::contains(unsigned entityId) const{
+
+    if (!driver || !driver->has(entityId))
+        return false;
+
+    for (unsigned i = 0; i < NUM_TYPES; i++)
+        if (basePools[i] != driver && !basePools[i]->has(entityId))
+            return false;
+
+    return true;
+}
+
+template<typename... Types>
+template<typename Func>
+void ComponentView<Types...>::each(Func func) const{
+
+    if (!driver)
+        return;
+
+    const vector<unsigned>& entities = driver->getEntities();
+    for (unsigned i = 0; i < entities.size(); i++){
+
+        unsigned entityId = entities[i];
+        if (contains(entityId))
+            func(entityId, *this->ViewPool<Types>::pool->get(entityId)...);
+    }
+}
+
+template<typename... Types>
+typename ComponentView<Types...>::Iterator ComponentView<Types...>::begin() const{
+    return Iterator(this, 0);
+}
+
+template<typename... Types>
+typename ComponentView<Types...>::Iterator ComponentView<Types...>::end() const{
+    return Iterator(this, driver ? driver->size() : 0);
+}
+
+template<typename... Types>
+ComponentView<Types...>::Iterator::Iterator(const ComponentView* view, unsigned index) :
+    view(view), index(index)
+{
+    skipUnmatched();
+}
+
+template<typename... Types>
+std::tuple<Types&...> ComponentView<Types...>::Iterator::operator*() const{
+    unsigned entityId = getEntity();
+    return std::tuple<Types&...>(*view->ViewPool<Types>::pool->get(entityId)...);
+}
+
+template<typename... Types>
+const typename ComponentView<Types...>::Iterator& ComponentView<Types...>::Iterator::operator++(){
+    index++;
+    skipUnmatched();
+    return *this;
+}
+
+template<typename... Types>
+bool ComponentView<Types...>::Iterator::operator!=(const Iterator& other) const{
+    return index != other.index;
+}
+
+template<typename... Types>
+unsigned ComponentView<Types...>::Iterator::getEntity() const{
+    return view->driver->getEntities()[index];
+}
+
+template<typename... Types>
+void ComponentView<Types...>::Iterator::skipUnmatched(){
+
+    if (!view->driver)
+        return;
+
+    unsigned size = view->driver->size();
+    while (index < size && !view->contains(getEntity()))
+        index++;
+}
+
+#endif // COMPONENTVIEW_H
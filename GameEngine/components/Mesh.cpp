@@ -1,21 +1,40 @@
 #include "Mesh.h"
+#include "Camera.h"
+#include "../math/Matrix3x4.h"
+#include "../util/Profiler.h"
+#include "../util/MeshCache.h"
+#include "../core/Engine.h"
 
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 using std::cout;
 
 Mesh::Mesh(const vector<Mesh::Vertex>& vertices, const vector<int>& indices){
     createMesh(vertices, indices);
+
+    for (const Vertex& vertex : vertices)
+        bounds.expand(vertex.position);
+
     wireframe = false;
     cullface = true;
     line = false;
 }
 
-Mesh::Mesh(const string& filepath){
-    IndexedModel model = OBJModel(filepath).ToIndexedModel();
-    createMesh(model);
+Mesh::Mesh(const string& filepath) : vertexArrayObjectID(0), renderCount(0), indexType(GL_UNSIGNED_INT),
+    indexSize(sizeof(GLuint)), lods(1, MeshLOD()), currentLOD(0){
+
+    // The cooked file is only mapped while its data is uploaded.
+    CookedMesh cookedMesh;
+    if (MeshCache::load(filepath, cookedMesh, Engine::getJobSystem())){
+        createMesh(cookedMesh);
+        bounds = cookedMesh.getBounds();
+    }
+
     wireframe = false;
     cullface = true;
+    line = false;
 }
 
 Mesh::~Mesh() {
@@ -25,23 +44,82 @@ Mesh::~Mesh() {
 
 void Mesh::createMesh(const vector<Mesh::Vertex>& vertices, const vector<int>& indices){
 
-    unsigned numVertices = vertices.size();
+    IndexedModel model;
+    model.positions.reserve(vertices.size());
+    model.texCoords.reserve(vertices.size());
+    model.normals.reserve(vertices.size());
 
-    // draw based on the indices, not how many vertices there are.
-    renderCount = indices.size();
+    for (const Vertex& vertex : vertices){
+        model.positions.push_back(vertex.position);
+        model.texCoords.push_back(vertex.uv);
+        model.normals.push_back(vertex.normal);
+    }
+
+    model.indices.assign(indices.begin(), indices.end());
+    createMesh(model);
+}
 
-    // render_count = num_vertices;
+void Mesh::createMesh(const IndexedModel& model, const VertexLayout& layout){
 
-    vector<Vector3> vertexPositions;
-    vector<Vector2> uvCoords;
-    vertexPositions.reserve(numVertices);
-    uvCoords.reserve(numVertices);
+    unsigned numVertices = model.positions.size();
+    unsigned numIndices = model.indices.size();
+    unsigned indexSize = getIndexSize(numVertices);
 
-    // store all vertex position and tex_coord data in the vectors
-    for(unsigned i = 0; i < numVertices; i++){
-        vertexPositions.push_back(vertices[i].position);
-        uvCoords.push_back(vertices[i].uv);
+    // Pack the model the same way a cooked mesh file is.
+    vector<char> vertices(numVertices * layout.getStride());
+    vector<char> indices(numIndices * indexSize);
+
+    if (numVertices > 0)
+        layout.writeModel(&vertices[0], model);
+    if (numIndices > 0)
+        writeIndices(&indices[0], &model.indices[0], numIndices, indexSize);
+
+    upload(vertices.empty() ? nullptr : &vertices[0], numVertices, layout,
+           indices.empty() ? nullptr : &indices[0], numIndices, indexSize);
+}
+
+void Mesh::createMesh(const CookedMesh& mesh){
+    upload(mesh.getVertices(), mesh.getVertexCount(), mesh.getLayout(),
+           mesh.getIndices(), mesh.getIndexCount(), mesh.getIndexSize());
+
+    lods.clear();
+    for (unsigned i = 0; i < mesh.getLODCount(); i++)
+        lods.push_back(mesh.getLOD(i));
+
+    setLOD(0);
+}
+
+// How OpenGL reads an attribute stored in the format.
+static void getGLFormat(VertexFormat format, GLint& components, GLenum& type, GLboolean& normalized){
+    components = VertexLayout::getComponentCount(format);
+    normalized = GL_FALSE;
+
+    switch (format){
+        case FORMAT_HALF2:
+            type = GL_HALF_FLOAT;
+        break;
+        case FORMAT_SNORM_10_10_10_2:
+            type = GL_INT_2_10_10_10_REV;
+            normalized = GL_TRUE;
+        break;
+        default:
+            type = GL_FLOAT;
+        break;
     }
+}
+
+void Mesh::upload(const void* vertices, unsigned vertexCount, const VertexLayout& layout,
+                  const void* indices, unsigned indexCount, unsigned indexSize){
+    PROFILE_ZONE("Mesh upload");
+
+    // draw based on the indices, not how many vertices there are.
+    renderCount = indexCount;
+    indexType = indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    this->indexSize = indexSize;
+
+    MeshLOD full = { 0, indexCount, 0 };
+    lods.assign(1, full);
+    currentLOD = 0;
 
     // Create a VAO for this mesh
     glGenVertexArrays(1, &vertexArrayObjectID);
@@ -50,104 +128,94 @@ void Mesh::createMesh(const vector<Mesh::Vertex>& vertices, const vector<int>& i
     // Generate the buffers so we can operate on the VAO
     glGenBuffers(NUM_BUFFERS, vertexArrayBuffers);
 
-    // Tell OpenGL to interpret the POSITION buffer data as an array
-    // and bind it.
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[POSITION]);
-
-    // Calculate the size (in memory) of the vertices for our buffer.
-    // We do this by taking the memory size of an individual vertex and
-    // multiplying it by how many there are.
-    unsigned size = numVertices * sizeof(vertexPositions.at(0));
-
     // Place vertex data in the buffer array.
     // 1st param: tell OpenGL to interpret the vertex data as an array.
     // 2nd param: the size (in memory) of the array buffer.
     // 3rd param: the starting point of the source vertex data.
     // 4th param: draw hint - tells OpenGL where to put the data in the GPU.
     // STATIC_DRAW means that the vertex data won't be modified (for optimization reasons).
-    glBufferData(GL_ARRAY_BUFFER, size, &vertexPositions.at(0), GL_STATIC_DRAW);
-
-    // Vertex attributes are just data of the vertex. For example, it can be
-    //  the position or color of the vertex.
-    // We must have these attributes in an array format (sequential in memory)
-    //  so OpenGL can process the attributes as an array.
-    // For example, all the position attributes are placed sequentially as an array
-    //  for OpenGL then all the color attributes are organized in the same way.
-
-    // This tells OpenGL that we are going to specify an attribute array for a
-    // certain Vertex data, in this case, the position.
-    // "0" is an ID for the attribute we want to specify
-    glEnableVertexAttribArray(0);
-
-    // Tell OpenGL to read the position attribute as an array.
-    // 1st param: takes the ID of the attribute.
-    // 2nd param: how many pieces of data for the attribute - for the position
-    //  case, it has 3 (x, y, and z)
-    // 3rd param: the data type for those pieces.
-    // 4th param: normalize the data
-    // 5th param: how much data to skip - 0 since we have position stored continuously in the positions vector
-    // 6th param: the starting point of the attribute data, 0 since it is the first
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-    // For texture coordinates
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[TEXTURE]);
-    size = numVertices * sizeof(uvCoords.at(0));
-    glBufferData(GL_ARRAY_BUFFER, size, &uvCoords.at(0), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[VERTEX]);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * layout.getStride(), vertices, GL_STATIC_DRAW);
 
-    // Attribute 1 is for the tex coords since it comes after position in the Vertex class
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    // The attributes of a vertex are interleaved, so each attribute array is read
+    // from the same buffer.
+    // 1st param: the ID of the attribute, which the shaders bind by name (see Shader).
+    // 2nd param: how many pieces of data for the attribute, e.g. 3 for x, y and z.
+    // 3rd param: the data type for those pieces.
+    // 4th param: map integers to [-1, 1] (for the packed normals).
+    // 5th param: how much data to skip to the next vertex - the size of a whole vertex.
+    // 6th param: where the attribute starts in a vertex.
+    for (unsigned i = 0; i < NUM_VERTEX_ATTRIBUTES; i++){
+        VertexAttribute attribute = VertexAttribute(i);
+
+        if (!layout.has(attribute)){
+            glDisableVertexAttribArray(attribute);
+            continue;
+        }
+
+        GLint components;
+        GLenum type;
+        GLboolean normalized;
+        getGLFormat(layout.getFormat(attribute), components, type, normalized);
+
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribPointer(attribute, components, type, normalized, layout.getStride(),
+                              (const GLvoid*)(uintptr_t)layout.getOffset(attribute));
+    }
 
     // Vertex draw order
     // GL Element array is an array that contains data that is part of data in another
     // buffer. In our case, the draw order is for the vertices.
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexArrayBuffers[INDEX]);
-    size = indices.size() * sizeof(indices.at(0));
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, &indices.at(0), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize, indices, GL_STATIC_DRAW);
 
     // Unbind the VAO
     glBindVertexArray(0);
 }
 
-void Mesh::createMesh(const IndexedModel& model){
+const AABB& Mesh::getBounds() const{
+    return bounds;
+}
 
-    unsigned num_vertices = model.positions.size();
+unsigned Mesh::getLODCount() const{
+    return lods.size();
+}
 
-    renderCount = model.indices.size();
+const MeshLOD& Mesh::getLOD(unsigned level) const{
+    return lods[level];
+}
 
-    // Create a VAO for this mesh
-    glGenVertexArrays(1, &vertexArrayObjectID);
-    glBindVertexArray(vertexArrayObjectID);
-    glGenBuffers(NUM_BUFFERS, vertexArrayBuffers);
+void Mesh::setLOD(unsigned level){
+    currentLOD = level < lods.size() ? level : lods.size() - 1;
+    renderCount = lods[currentLOD].indexCount;
+}
 
-    // For vertex positions
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[POSITION]);
-    unsigned size = num_vertices * sizeof(model.positions.at(0));
-    glBufferData(GL_ARRAY_BUFFER, size, &model.positions.at(0), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-    // For texture coordinates
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[TEXTURE]);
-    size = num_vertices * sizeof(model.texCoords.at(0));
-    glBufferData(GL_ARRAY_BUFFER, size, &model.texCoords.at(0), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-    // For normals
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffers[NORMAL]);
-    size = model.normals.size() * sizeof(model.normals.at(0));
-    glBufferData(GL_ARRAY_BUFFER, size, &model.normals.at(0), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, 0);
+unsigned Mesh::getCurrentLOD() const{
+    return currentLOD;
+}
 
-    // Vertex draw order
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexArrayBuffers[INDEX]);
-    size = model.indices.size() * sizeof(model.indices.at(0));
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, &model.indices.at(0), GL_STATIC_DRAW);
+unsigned Mesh::selectLOD(const Camera& camera, const Matrix3x4& world, float viewportHeight, float maxPixelError){
 
-    // Unbind the VAO
-    glBindVertexArray(0);
+    // Errors are in model space. The largest scale of the world matrix bounds how
+    // much they grow in the world.
+    float scale = 0;
+    for (unsigned axis = 0; axis < 3; axis++){
+        Vector3 direction;
+        direction[axis] = 1;
+        scale = std::max(scale, Vector3(world.transformDirection(direction)).magnitude());
+    }
+
+    // Measured from the closest point of the bounding sphere, so the error is never underestimated.
+    Vector3 center = world.transformPoint(bounds.getCenter());
+    float radius = bounds.getExtents().magnitude() * scale;
+    float distance = (center - camera.transform.position).magnitude() - radius;
+
+    unsigned level = lods.size() - 1;
+    while (level > 0 && camera.getProjectedSize(lods[level].error * scale, distance, viewportHeight) > maxPixelError)
+        level--;
+
+    setLOD(level);
+    return level;
 }
 
 void Mesh::render() const{
@@ -159,9 +227,10 @@ void Mesh::render() const{
     //glDrawArrays(GL_TRIANGLES, 0, render_count);
 
     // draw based on the indices.
-    // 3rd param is the data type of the indices
-    // 4th param is the starting element - 0 for the beginning of the indices array
+    // 3rd param is the data type of the indices (16 or 32 bits, see getIndexSize())
+    // 4th param is the byte offset of the first index - where the current level of detail starts
     // glDrawElements(GL_LINES, render_count, GL_UNSIGNED_INT, 0)
+    const GLvoid* firstIndex = (const GLvoid*)(uintptr_t)(lods[currentLOD].firstIndex * indexSize);
 
     // Apply face culling
     if (cullface)
@@ -179,9 +248,9 @@ void Mesh::render() const{
 
     // To use lines or triangles
     if (line)
-        glDrawElements(GL_LINES, renderCount, GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_LINES, renderCount, indexType, firstIndex);
     else
-        glDrawElements(GL_TRIANGLES, renderCount, GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, renderCount, indexType, firstIndex);
 
     glBindVertexArray(0);
 }
@@ -12,10 +12,15 @@
 #include <string>
 
 #include "../util/OBJModel.h"
+#include "../util/CookedMesh.h"
+#include "../math/AABB.h"
 
 using std::vector;
 using std::string;
 
+class Camera;
+class Matrix3x4;
+
 class Mesh{
 
 public:
@@ -42,12 +47,29 @@ public:
 
     Mesh(const vector<Vertex>& vertices, const vector<int>& indices);
 
-    // File path of the model.
+    // File path of the model. The model is loaded through the mesh cache (see MeshCache).
     Mesh(const string& filepath);
     ~Mesh();
 
     void render() const;
 
+    // The box around the vertices of the mesh, in model space.
+    const AABB& getBounds() const;
+
+    // The levels of detail of the mesh, 0 being the full mesh (see MeshSimplifier).
+    // Meshes loaded from a file get them when they are cooked, others only have level 0.
+    unsigned getLODCount() const;
+    const MeshLOD& getLOD(unsigned level) const;
+
+    // The level drawn by render().
+    void setLOD(unsigned level);
+    unsigned getCurrentLOD() const;
+
+    // Draws the coarsest level whose error covers at most maxPixelError pixels on the screen,
+    // for the mesh placed with the world matrix and a viewport viewportHeight pixels tall.
+    // Returns the level.
+    unsigned selectLOD(const Camera& camera, const Matrix3x4& world, float viewportHeight, float maxPixelError = 1.0f);
+
     // Flag to tell OpenGL to render the mesh using lines.
     bool wireframe;
 
@@ -62,12 +84,22 @@ private:
     // Create the mesh from a list of vertices and indices
     void createMesh(const vector<Vertex>&, const vector<int>&);
 
-    // Create the mesh from an indexed model
-    void createMesh(const IndexedModel&);
+    // Create the mesh from an indexed model, with its vertices packed in the layout.
+    // Full precision by default: only cooked meshes are quantized (see MeshCache).
+    void createMesh(const IndexedModel&, const VertexLayout& layout = VertexLayout::full());
+
+    // Create the mesh straight from the memory of a cooked mesh file.
+    void createMesh(const CookedMesh&);
+
+    // Upload the interleaved vertices and the indices, and point the attributes
+    // of the layout at the vertex buffer.
+    void upload(const void* vertices, unsigned vertexCount, const VertexLayout& layout,
+                const void* indices, unsigned indexCount, unsigned indexSize);
 
     // Enumerations for the different types of buffers.
+    // VERTEX holds all the attributes of the vertices, one vertex after the other.
     // INDEX represents the draw order of a vertex.
-    enum { POSITION, TEXTURE, NORMAL, INDEX, NUM_BUFFERS };
+    enum { VERTEX, INDEX, NUM_BUFFERS };
 
     // This will refer to mesh data on GPU
     GLuint vertexArrayObjectID;
@@ -75,6 +107,16 @@ private:
 
     // specifies how much of the mesh we need to render
     unsigned renderCount;
+
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, and its size in bytes
+    GLenum indexType;
+    unsigned indexSize;
+
+    // Never empty. A mesh whose file failed to load has an empty level 0, and draws nothing.
+    vector<MeshLOD> lods;
+    unsigned currentLOD;
+
+    AABB bounds;
 };
 
 #endif // MESH_H
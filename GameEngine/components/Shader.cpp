@@ -1,6 +1,8 @@
 
 #include "Shader.h"
+#include "../util/Profiler.h"
 #include "../core/Engine.h"
+#include "../util/VertexLayout.h"
 
 #include <fstream>
 #include <vector>
@@ -26,9 +28,9 @@ Shader::Shader(const string& shader_filepath){
     }
 
     // This needs to be done before linking and validation.
-    glBindAttribLocation(programID, 0, "position");
-    glBindAttribLocation(programID, 1, "tex_coord");
-    glBindAttribLocation(programID, 2, "normal");
+    // The locations are the ones meshes upload their vertex attributes to (see VertexLayout).
+    for (unsigned i = 0; i < NUM_VERTEX_ATTRIBUTES; i++)
+        glBindAttribLocation(programID, i, VertexLayout::getAttributeName(VertexAttribute(i)));
 
     // Link the compiled shader program to the main application
     glLinkProgram(programID);
@@ -61,6 +63,7 @@ Shader::~Shader(){
 }
 
 void Shader::bind() const{
+    PROFILE_ZONE("Shader::bind");
     glUseProgram(programID);
 }
 
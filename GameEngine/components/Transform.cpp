@@ -1,5 +1,9 @@
 #include "Transform.h"
 #include "MeasurementUnits.h"
+#include "../entity/EntityId.h"
+#include "../core/Engine.h"
+
+std::atomic<unsigned> Transform::hierarchyVersion(0);
 
 Transform::Transform(unsigned entityId, const Vector3& position, const Quaternion& rotation, const Vector3& scale) :
     Component(entityId), position(position), rotation(rotation), scale(scale)
@@ -7,25 +11,55 @@ Transform::Transform(unsigned entityId, const Vector3& position, const Quaternio
     oldPosition = position;
     oldScale = scale;
     oldRotation = rotation;
-    parent = nullptr;
+    parentId = INVALID_ENTITY;
+
+    // Valid as long as there is no parent, until the transform system runs.
+    world = localMatrix();
+    worldChanged = true;
+}
+
+Matrix3x4 Transform::localMatrix() const{
+    return Matrix3x4::fromTRS(position, rotation, scale);
+}
+
+const Matrix3x4& Transform::worldMatrix() const{
+    return world;
 }
 
 Matrix4 Transform::modelMatrix() const{
+    if (Engine::componentManager.getComponent<Transform>(getEntityId()) == this)
+        return world.toMatrix4();
+
+    Matrix3x4 matrix = localMatrix();
 
-    Matrix4 posMat = Matrix4::translation(position);
-    Matrix4 rotMat = rotation.toMatrix();
-    Matrix4 scaleMat = Matrix4::scale(scale);
+    // Bounded, since the parents may loop until the transform system breaks the loop.
+    unsigned ancestorId = parentId;
+    for (unsigned depth = 0; ancestorId != INVALID_ENTITY && depth < MAX_ENTITIES; depth++){
+        const Transform* ancestor = Engine::componentManager.getComponent<Transform>(ancestorId);
+        if (!ancestor)
+            break;
 
-    // Have the transform relative to the parent
-    return getParentMatrix() * posMat * rotMat * scaleMat;
+        matrix = ancestor->localMatrix() * matrix;
+        ancestorId = ancestor->parentId;
+    }
+
+    return matrix.toMatrix4();
 }
 
-void Transform::setParent(Transform* const parent){
-    this->parent = parent;
+void Transform::setParent(unsigned parentEntityId){
+    if (parentId == parentEntityId)
+        return;
+
+    parentId = parentEntityId;
+    hierarchyVersion++;
+}
 
-    // Update the parent matrix
-    if (parent)
-        parentMatrix = parent->modelMatrix();
+void Transform::setParent(const Transform* parent){
+    setParent(parent ? parent->getEntityId() : INVALID_ENTITY);
+}
+
+unsigned Transform::getParentId() const{
+    return parentId;
 }
 
 void Transform::update(){
@@ -35,9 +69,10 @@ void Transform::update(){
 }
 
 bool Transform::hasChanged() const{
+    return worldChanged || hasLocalChanged();
+}
 
-    if (parent && parent->hasChanged())
-        return true;
+bool Transform::hasLocalChanged() const{
 
     if (position != oldPosition)
         return true;
@@ -51,10 +86,8 @@ bool Transform::hasChanged() const{
     return false;
 }
 
-const Matrix4& Transform::getParentMatrix() const{
-    if (parent && parent->hasChanged())
-        parentMatrix = parent->modelMatrix();
-    return parentMatrix;
+unsigned Transform::getHierarchyVersion(){
+    return hierarchyVersion;
 }
 
 const char* Transform::getName() const{
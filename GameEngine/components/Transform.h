@@ -1,9 +1,12 @@
 #ifndef TRANSFORM_H
 #define TRANSFORM_H
 
+#include <atomic>
+
 #include "Component.h"
 #include "../math/Vector3.h"
 #include "../math/Matrix4.h"
+#include "../math/Matrix3x4.h"
 #include "../math/Quaternion.h"
 
 class Transform : public Component{
@@ -14,13 +17,37 @@ public:
                 const Quaternion& rotation = Quaternion(),
                 const Vector3& scale = Vector3(1, 1, 1));
 
-    // Convert the transform into a matrix
+    // The transform relative to the parent.
+    Matrix3x4 localMatrix() const;
+
+    // The transform in the world, including the parents'.
+    // Computed once per frame for every transform in the engine's pool by the
+    // TransformSystem, so it misses changes made after the system ran.
+    const Matrix3x4& worldMatrix() const;
+
+    // Convert the transform into a matrix, to upload it to a shader.
+    // For a transform in the engine's pool this is the world matrix, as of the last
+    // TransformSystem pass. Transforms outside the pool (e.g. a camera's) are not
+    // updated by the system, so their matrix is computed from the local transforms
+    // of their parents instead, at the cost of a lookup per parent.
     Matrix4 modelMatrix() const;
 
-    void setParent(Transform* const);
+    // The parent is referred to by its entity, since components move inside their pool.
+    // An entity without a transform (or INVALID_ENTITY) leaves the transform at the root.
+    void setParent(unsigned parentEntityId);
+    void setParent(const Transform* parent);
+    unsigned getParentId() const;
 
+    // Marks the current position, rotation and scale as seen.
     void update();
+
+    // Returns true if the local transform changed since the last update(), or if
+    // the world matrix was recomputed by the last TransformSystem pass.
     bool hasChanged() const;
+    bool hasLocalChanged() const;
+
+    // Changes whenever a parent is set, so the hierarchy can be rebuilt.
+    static unsigned getHierarchyVersion();
 
     Vector3 position;
     Quaternion rotation;
@@ -29,12 +56,14 @@ public:
     const char* getName() const;
 
 private:
-    const Matrix4& getParentMatrix() const;
+    friend class TransformSystem;
+
+    unsigned parentId;
 
-    Transform* parent;
+    Matrix3x4 world;
+    bool worldChanged;
 
-    // Allow it to be modified inside getParentMatrix() if it needs to be updated.
-    mutable Matrix4 parentMatrix;
+    static std::atomic<unsigned> hierarchyVersion;
 
     Vector3 oldPosition;
     Quaternion oldRotation;
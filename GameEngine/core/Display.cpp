@@ -3,6 +3,7 @@
 #include <iostream>
 #include <SDL2/SDL_opengl.h>
 #include "../util/GraphicsUtil.h"
+#include "../util/Profiler.h"
 
 using std::cout;
 using std::endl;
@@ -23,10 +24,12 @@ Display::~Display(){
 }
 
 void Display::update() const{
+    PROFILE_ZONE("Display::update");
     SDL_GL_SwapWindow(window);
 }
 
 void Display::clear(unsigned r, unsigned g, unsigned b, unsigned a) const{
+    PROFILE_ZONE("Display::clear");
 
     if (r <= 255 && g <= 255 && b <= 255 && a <= 255){
         glClearColor(r/255.0f, g/255.0f, b/255.0f, a/255.0f);
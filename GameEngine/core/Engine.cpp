@@ -8,11 +8,14 @@
  */
 
 #include <iostream>
+#include <cmath>
 #include <GL/glew.h>
 #include <SDL2/SDL_image.h>
 
 #include "Engine.h"
 #include "../util/Timer.h"
+#include "../util/Profiler.h"
+#include "../systems/TransformSystem.h"
 
 using std::cout;
 using std::endl;
@@ -21,12 +24,19 @@ using std::cerr;
 // define statics
 Display* Engine::display = nullptr;
 float Engine::deltaTime = 0;
+float Engine::fixedDeltaTime = 0;
+float Engine::interpolationAlpha = 0;
+const char* const Engine::TRACE_FILE_PATH = "trace.json";
+JobSystem* Engine::jobSystem = nullptr;
 
 ComponentManager Engine::componentManager;
+EntityManager Engine::entityManager(Engine::componentManager);
 unordered_map<GLenum, string> Engine::glTypeNames;
 
-Engine::Engine() : glcontext(nullptr){
+Engine::Engine() : glcontext(nullptr), accumulator(0), maxCatchUpSteps(5){
 
+    // Registered first, so the frame systems that read transforms run after it.
+    frameSystems.addSystem(new TransformSystem(componentManager));
 }
 
 Engine::~Engine(){
@@ -43,31 +53,96 @@ void Engine::run(){
     {
         timer.start();
 
-        // Handle input
-        while( SDL_PollEvent( &event ) != 0 ){
+        {
+            PROFILE_ZONE("Frame");
 
-            // Quit program
-            if (event.type == SDL_QUIT)
-                quit = true;
+            {
+                PROFILE_ZONE("Input");
 
-            else if (event.type == SDL_KEYDOWN){
-                if (event.key.keysym.sym == SDLK_t)
-                    Engine::getDisplay()->toggleFullscreen();
+                // Handle input
+                while( SDL_PollEvent( &event ) != 0 ){
 
-                // Terminate program via escape key
-                if (event.key.keysym.sym == SDLK_ESCAPE)
-                    quit = true;
+                    // Quit program
+                    if (event.type == SDL_QUIT)
+                        quit = true;
+
+                    else if (event.type == SDL_KEYDOWN){
+                        if (event.key.keysym.sym == SDLK_t)
+                            Engine::getDisplay()->toggleFullscreen();
+
+                        // Print the profiler stats of the recent frames
+                        if (event.key.keysym.sym == SDLK_p)
+                            Profiler::report(cout);
+
+                        // Start or stop writing the frame timeline to a trace file
+                        if (event.key.keysym.sym == SDLK_F9)
+                            toggleTrace();
+
+                        // Terminate program via escape key
+                        if (event.key.keysym.sym == SDLK_ESCAPE)
+                            quit = true;
+                    }
+                }
+            }
+
+            {
+                PROFILE_ZONE("Simulation");
+                Engine::interpolationAlpha = updateSimulation();
+            }
+
+            {
+                PROFILE_ZONE("Frame systems");
+                frameSystems.update(Engine::deltaTime, *jobSystem);
+            }
+
+            {
+                PROFILE_ZONE("Command playback");
+
+                // Sync point. Apply the structural changes recorded during the frame.
+                CommandBuffer::playbackAll(entityManager, componentManager);
+            }
+
+            {
+                PROFILE_ZONE("Display");
+                Engine::getDisplay()->clear(0, 0, 0, 0);
+                Engine::getDisplay()->update();
             }
         }
 
-        Engine::getDisplay()->clear(0, 0, 0, 0);
-        Engine::getDisplay()->update();
+        Profiler::endFrame();
 
         // Set delta time
         Engine::deltaTime = timer.getElapsedSeconds();
     }
 }
 
+float Engine::updateSimulation(){
+
+    if (fixedDeltaTime <= 0){
+        simulationSystems.update(Engine::deltaTime, *jobSystem);
+        return 1;
+    }
+
+    accumulator += Engine::deltaTime;
+
+    unsigned steps = 0;
+    while (accumulator >= fixedDeltaTime && steps < maxCatchUpSteps){
+        simulationSystems.update(fixedDeltaTime, *jobSystem);
+
+        // Every step must see the changes of the previous one.
+        CommandBuffer::playbackAll(entityManager, componentManager);
+
+        accumulator -= fixedDeltaTime;
+        steps++;
+    }
+
+    // Fell behind. Drop the whole steps left rather than running them next frame.
+    if (accumulator >= fixedDeltaTime)
+        accumulator = std::fmod(accumulator, fixedDeltaTime);
+
+    return accumulator / fixedDeltaTime;
+}
+
 bool Engine::initialize(){
 
     // Order of function calling matters here. SDL must be initialized so we can create the
@@ -166,6 +241,9 @@ bool Engine::initializeSDL(){
 bool Engine::initializeSubSystems(){
     setGlTypeNames();
 
+    jobSystem = new JobSystem();
+    cout << "Started " << jobSystem->getWorkerCount() << " job worker threads.\n";
+
     return true;
 }
 
@@ -186,10 +264,53 @@ bool Engine::createDisplay(){
 void Engine::cleanUp(){
     cout << "Cleaning up and deallocating...\n";
 
+    // Workers may still hold command buffers, so stop them first.
+    delete jobSystem;
+    jobSystem = nullptr;
+
+    CommandBuffer::destroyThreadBuffers();
+
+    Profiler::stopTrace();
+    Profiler::destroyThreadBuffers();
+
     delete display;
     SDL_Quit();
 }
 
+void Engine::toggleTrace(){
+
+    if (Profiler::isTracing()){
+        Profiler::stopTrace();
+        cout << "Stopped writing the trace.\n";
+    }
+
+    else if (Profiler::startTrace(TRACE_FILE_PATH))
+        cout << "Writing the trace to " << TRACE_FILE_PATH << endl;
+}
+
+void Engine::addSystem(System* system){
+    simulationSystems.addSystem(system);
+}
+
+void Engine::addFrameSystem(System* system){
+    frameSystems.addSystem(system);
+}
+
+void Engine::setFixedUpdateRate(float updatesPerSecond){
+
+    if (updatesPerSecond < 0){
+        cerr << "Error. The fixed update rate can not be negative.\n";
+        return;
+    }
+
+    fixedDeltaTime = updatesPerSecond > 0 ? 1 / updatesPerSecond : 0;
+    accumulator = 0;
+}
+
+void Engine::setMaxCatchUpSteps(unsigned steps){
+    maxCatchUpSteps = steps > 0 ? steps : 1;
+}
+
 Display* Engine::getDisplay(){
     return display;
 }
@@ -198,6 +319,22 @@ float Engine::getDeltaTime(){
     return deltaTime;
 }
 
+float Engine::getFixedDeltaTime(){
+    return fixedDeltaTime;
+}
+
+float Engine::getInterpolationAlpha(){
+    return interpolationAlpha;
+}
+
+JobSystem* Engine::getJobSystem(){
+    return jobSystem;
+}
+
+CommandBuffer& Engine::getCommandBuffer(){
+    return CommandBuffer::getThreadBuffer(entityManager);
+}
+
 void Engine::getGlTypeName(const GLenum type, string& name){
     const auto itr = glTypeNames.find(type);
     if (itr != glTypeNames.end()){
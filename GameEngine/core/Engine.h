@@ -12,6 +12,10 @@
 
 #include "Display.h"
 #include "../components/ComponentManager.h"
+#include "../entity/EntityManager.h"
+#include "../entity/CommandBuffer.h"
+#include "../systems/SystemScheduler.h"
+#include "JobSystem.h"
 
 using std::unordered_map;
 
@@ -24,10 +28,44 @@ public:
     bool initialize();
     void run();
 
+    // Registers a simulation system. The engine takes ownership of it.
+    // With a fixed update rate it runs at that rate, otherwise once per frame.
+    void addSystem(System* system);
+
+    // Registers a system updated once per frame with the frame's delta time,
+    // e.g. rendering. The engine takes ownership of it.
+    // Frame systems see the world matrices of this frame (see TransformSystem).
+    void addFrameSystem(System* system);
+
+    // Run the simulation systems this many times per second, independently of the
+    // frame rate. A rate of 0 updates them once per frame (the default).
+    void setFixedUpdateRate(float updatesPerSecond);
+
+    // The most simulation steps run in one frame. Time left behind after that is
+    // dropped, so a slow simulation can not keep falling further behind.
+    void setMaxCatchUpSteps(unsigned steps);
+
     static Display* getDisplay();
     static float getDeltaTime();
 
+    // The time step of the simulation systems, 0 if they update once per frame.
+    static float getFixedDeltaTime();
+
+    // How far the frame is between the last two simulation steps, in [0, 1).
+    // Renderers blend the previous and current simulation states with it.
+    // Always 1 when the simulation updates once per frame.
+    static float getInterpolationAlpha();
+
+    // The job system shared by the engine subsystems, e.g. systems, asset loading and culling.
+    static JobSystem* getJobSystem();
+
     static ComponentManager componentManager;
+    static EntityManager entityManager;
+
+    // The command buffer of the calling thread. Use it to add or remove components
+    // and destroy entities while systems are iterating. Recorded commands are
+    // applied at the end of the frame.
+    static CommandBuffer& getCommandBuffer();
 
     // Sets the string representation of the OpenGL enum type.
     static void getGlTypeName(const GLenum type, string& name);
@@ -41,6 +79,23 @@ private:
     SDL_GLContext glcontext;
 
     float static deltaTime;
+    float static fixedDeltaTime;
+    float static interpolationAlpha;
+
+    // The frame time not yet simulated by fixed steps.
+    float accumulator;
+    unsigned maxCatchUpSteps;
+
+    static JobSystem* jobSystem;
+    SystemScheduler simulationSystems;
+    SystemScheduler frameSystems;
+
+    // Runs the simulation systems and returns the interpolation alpha.
+    float updateSimulation();
+
+    // Where F9 writes the Chrome trace of the frames (see Profiler).
+    static const char* const TRACE_FILE_PATH;
+    void toggleTrace();
 
     static unordered_map<GLenum, string> glTypeNames;
     static void setGlTypeNames();
@@ -0,0 +1,159 @@
+#include "JobSystem.h"
+
+// The job system and queue of the calling thread.
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local unsigned currentQueueIndex = 0;
+
+JobCounter::JobCounter() : count(0)
+{
+    //ctor
+}
+
+bool JobCounter::isDone() const{
+    return count.load() == 0;
+}
+
+JobSystem::JobSystem(unsigned workerCount) : queuedJobs(0), stopping(false){
+
+    for (unsigned i = 0; i < workerCount + 1; i++)
+        queues.push_back(new WorkQueue());
+
+    currentJobSystem = this;
+    currentQueueIndex = 0;
+
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.push_back(std::thread(&JobSystem::workerLoop, this, i + 1));
+}
+
+JobSystem::~JobSystem(){
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    jobQueued.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    for (WorkQueue* queue : queues)
+        delete queue;
+
+    if (currentJobSystem == this)
+        currentJobSystem = nullptr;
+}
+
+void JobSystem::run(const std::function<void()>& job, JobCounter* counter){
+
+    if (counter)
+        counter->count++;
+
+    // Counted before it is queued so the count never drops below the queued jobs.
+    queuedJobs++;
+
+    WorkQueue* queue = queues[getQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(Job{job, counter});
+    }
+
+    // Taking the lock makes sure a worker about to sleep sees the new job.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    jobQueued.notify_one();
+}
+
+void JobSystem::wait(const JobCounter& counter){
+    while (!counter.isDone()){
+
+        // Help with the work instead of blocking.
+        if (!runPendingJob())
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::runPendingJob(){
+
+    unsigned queueIndex = getQueueIndex();
+
+    Job job;
+    if (!popJob(queueIndex, job) && !stealJob(queueIndex, job))
+        return false;
+
+    execute(job);
+    return true;
+}
+
+unsigned JobSystem::getWorkerCount() const{
+    return workers.size();
+}
+
+unsigned JobSystem::defaultWorkerCount(){
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobSystem::workerLoop(unsigned queueIndex){
+
+    currentJobSystem = this;
+    currentQueueIndex = queueIndex;
+
+    while (true){
+
+        if (runPendingJob())
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        jobQueued.wait(lock, [this]{ return stopping || queuedJobs.load() > 0; });
+
+        // Finish the queued jobs before stopping.
+        if (stopping && queuedJobs.load() == 0)
+            return;
+    }
+}
+
+unsigned JobSystem::getQueueIndex() const{
+    return currentJobSystem == this ? currentQueueIndex : 0;
+}
+
+bool JobSystem::popJob(unsigned queueIndex, Job& job){
+
+    WorkQueue* queue = queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue->mutex);
+
+    if (queue->jobs.empty())
+        return false;
+
+    // Newest first, its data is the most likely to still be in cache.
+    job = queue->jobs.back();
+    queue->jobs.pop_back();
+    queuedJobs--;
+    return true;
+}
+
+bool JobSystem::stealJob(unsigned thiefIndex, Job& job){
+
+    // Start with the next queue so thieves spread over the victims.
+    for (unsigned i = 1; i < queues.size(); i++){
+
+        WorkQueue* queue = queues[(thiefIndex + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+
+        if (queue->jobs.empty())
+            continue;
+
+        // Oldest first, it is usually the biggest piece of work left.
+        job = queue->jobs.front();
+        queue->jobs.pop_front();
+        queuedJobs--;
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job){
+    job.function();
+
+    if (job.counter)
+        job.counter->count--;
+}
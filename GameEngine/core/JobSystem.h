@@ -0,0 +1,128 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using std::vector;
+
+// Counts the unfinished jobs it was attached to.
+// Waiting on a counter is how a job depends on other jobs.
+class JobCounter
+{
+public:
+    JobCounter();
+
+    bool isDone() const;
+
+private:
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    std::atomic<unsigned> count;
+
+    friend class JobSystem;
+};
+
+// A work stealing job scheduler.
+// Every worker, and the thread that created the job system, owns a queue of jobs.
+// A thread pops its own newest job first, and steals the oldest job of another
+// queue when its own is empty.
+class JobSystem
+{
+public:
+
+    // Zero workers is valid: jobs then run on the threads that wait for them.
+    JobSystem(unsigned workerCount = defaultWorkerCount());
+    ~JobSystem();
+
+    // Queue the job on the calling thread's queue.
+    // The counter, if any, is done once the job and all others attached to it finished.
+    void run(const std::function<void()>& job, JobCounter* counter = nullptr);
+
+    // Runs other jobs until the counter is done.
+    void wait(const JobCounter& counter);
+
+    // Runs one queued job, if there is any. Returns false if there was none.
+    bool runPendingJob();
+
+    // Calls func(first, last) over [begin, end) split in ranges of grainSize
+    // elements and returns when all of them are done.
+    // A grain size of 0 splits the range evenly over the threads.
+    template<typename Func>
+    void parallelFor(unsigned begin, unsigned end, unsigned grainSize, Func func);
+
+    unsigned getWorkerCount() const;
+
+    // One worker per hardware thread, minus the main thread.
+    static unsigned defaultWorkerCount();
+
+private:
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    struct Job{
+        std::function<void()> function;
+        JobCounter* counter;
+    };
+
+    struct WorkQueue{
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(unsigned queueIndex);
+
+    // The queue owned by the calling thread. Threads unknown to the job system share the first one.
+    unsigned getQueueIndex() const;
+
+    bool popJob(unsigned queueIndex, Job& job);
+    bool stealJob(unsigned thiefIndex, Job& job);
+    void execute(Job& job);
+
+    vector<std::thread> workers;
+
+    // Queue 0 belongs to the creating thread, queue i to worker i - 1.
+    vector<WorkQueue*> queues;
+
+    // Idle workers sleep until a job is queued.
+    std::atomic<unsigned> queuedJobs;
+    std::mutex sleepMutex;
+    std::condition_variable jobQueued;
+    bool stopping;
+};
+
+template<typename Func>
+void JobSystem::parallelFor(unsigned begin, unsigned end, unsigned grainSize, Func func){
+
+    if (begin >= end)
+        return;
+
+    unsigned count = end - begin;
+    if (grainSize == 0){
+        // A few ranges per thread leaves room to balance the load by stealing.
+        unsigned ranges = (getWorkerCount() + 1) * 4;
+        grainSize = (count + ranges - 1) / ranges;
+    }
+
+    // A single range is not worth queuing.
+    if (count <= grainSize){
+        func(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    for (unsigned first = begin; first < end; first += grainSize){
+        unsigned last = end - first > grainSize ? first + grainSize : end;
+        run([&func, first, last]{ func(first, last); }, &counter);
+    }
+
+    wait(counter);
+}
+
+#endif // JOBSYSTEM_H
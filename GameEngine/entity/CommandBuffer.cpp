@@ -0,0 +1,114 @@
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+vector<CommandBuffer*> CommandBuffer::threadBuffers;
+std::mutex CommandBuffer::threadBuffersMutex;
+
+CommandBuffer::CommandBuffer(EntityManager& entityManager) :
+    entityManager(entityManager)
+{
+    //ctor
+}
+
+unsigned CommandBuffer::createEntity(){
+    return entityManager.create();
+}
+
+void CommandBuffer::destroyEntity(unsigned entityId){
+    Command command = { DESTROY_ENTITY, 0, entityId, nullptr };
+    commands.push_back(command);
+}
+
+void CommandBuffer::playback(ComponentManager& componentManager){
+    apply(commands, entityManager, componentManager);
+    commands.clear();
+}
+
+bool CommandBuffer::empty() const{
+    return commands.empty();
+}
+
+void CommandBuffer::clear(){
+    commands.clear();
+}
+
+CommandBuffer& CommandBuffer::getThreadBuffer(EntityManager& entityManager){
+
+    static thread_local CommandBuffer* buffer = nullptr;
+
+    if (!buffer){
+        buffer = new CommandBuffer(entityManager);
+
+        std::lock_guard<std::mutex> lock(threadBuffersMutex);
+        threadBuffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+void CommandBuffer::playbackAll(EntityManager& entityManager, ComponentManager& componentManager){
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    if (threadBuffers.empty())
+        return;
+
+    // Gather the commands of every thread, in the order the buffers were created.
+    vector<Command> commands;
+    for (CommandBuffer* buffer : threadBuffers){
+        commands.insert(commands.end(), buffer->commands.begin(), buffer->commands.end());
+        buffer->commands.clear();
+    }
+
+    apply(commands, entityManager, componentManager);
+}
+
+void CommandBuffer::destroyThreadBuffers(){
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    for (CommandBuffer* buffer : threadBuffers)
+        delete buffer;
+
+    threadBuffers.clear();
+}
+
+void CommandBuffer::apply(vector<Command>& commands, EntityManager& entityManager, ComponentManager& componentManager){
+
+    if (commands.empty())
+        return;
+
+    // Group component commands by type so each pool is touched in one run,
+    // and destroy entities last. The sort is stable so the commands on the
+    // same entity and component type keep their recorded order.
+    std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b){
+        if (a.type == DESTROY_ENTITY || b.type == DESTROY_ENTITY)
+            return a.type != DESTROY_ENTITY && b.type == DESTROY_ENTITY;
+        return a.componentTypeId < b.componentTypeId;
+    });
+
+    vector<unsigned> destroyed;
+
+    for (const Command& command : commands){
+        switch (command.type){
+
+            case ADD_COMPONENT:
+                // The entity may have been destroyed since the command was recorded.
+                if (entityManager.isAlive(command.entityId))
+                    command.add(componentManager, command.entityId);
+                break;
+
+            case REMOVE_COMPONENT:
+                // Same as above: the id may have been recycled since.
+                if (entityManager.isAlive(command.entityId))
+                    componentManager.removeComponent(command.componentTypeId, command.entityId);
+                break;
+
+            case DESTROY_ENTITY:
+                destroyed.push_back(command.entityId);
+                break;
+        }
+    }
+
+    entityManager.destroyAll(destroyed);
+}
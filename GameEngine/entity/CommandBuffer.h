@@ -0,0 +1,95 @@
+#ifndef COMMANDBUFFER_H
+#define COMMANDBUFFER_H
+
+#include <vector>
+#include <mutex>
+
+#include "EntityManager.h"
+#include "../components/ComponentManager.h"
+
+using std::vector;
+
+// Records structural changes (entity destruction, component addition and
+// removal) so they can be applied later in one batch, at a point where no
+// system is iterating the component pools.
+// Entity ids are handed out right away so later commands can refer to them;
+// the entity simply has no components until the buffer is played back.
+// A buffer must only be used by one thread at a time. Every thread can obtain
+// its own buffer through getThreadBuffer().
+class CommandBuffer
+{
+public:
+    CommandBuffer(EntityManager&);
+
+    // Creates an entity whose components will be added on playback.
+    unsigned createEntity();
+    void destroyEntity(unsigned entityId);
+
+    template<typename T>
+    void addComponent(unsigned entityId);
+
+    template<typename T>
+    void removeComponent(unsigned entityId);
+
+    // Applies the recorded commands and clears the buffer.
+    void playback(ComponentManager&);
+
+    bool empty() const;
+    void clear();
+
+    // Returns the buffer of the calling thread, creating it on first use.
+    static CommandBuffer& getThreadBuffer(EntityManager&);
+
+    // Plays back the buffers of all threads as one batch.
+    // Must be called while no other thread records commands.
+    static void playbackAll(EntityManager&, ComponentManager&);
+
+    // Deletes the buffers of all threads. Only to be used on shutdown.
+    static void destroyThreadBuffers();
+
+private:
+
+    // Command kinds in the order they are played back.
+    enum CommandType { ADD_COMPONENT, REMOVE_COMPONENT, DESTROY_ENTITY };
+
+    struct Command{
+        CommandType type;
+        unsigned componentTypeId;
+        unsigned entityId;
+
+        // Creates the component, since its type is only known when recording.
+        void (*add)(ComponentManager&, unsigned entityId);
+    };
+
+    template<typename T>
+    static void addComponentOfType(ComponentManager&, unsigned entityId);
+
+    // Sorts and applies commands gathered from one or more buffers.
+    static void apply(vector<Command>& commands, EntityManager&, ComponentManager&);
+
+    EntityManager& entityManager;
+    vector<Command> commands;
+
+    // The buffers handed out by getThreadBuffer().
+    static vector<CommandBuffer*> threadBuffers;
+    static std::mutex threadBuffersMutex;
+};
+
+template<typename T>
+void CommandBuffer::addComponent(unsigned entityId){
+    Command command = { ADD_COMPONENT, ComponentType::getId<T>(), entityId, &CommandBuffer::addComponentOfType<T> };
+    commands.push_back(command);
+}
+
+template<typename T>
+void CommandBuffer::removeComponent(unsigned entityId){
+    Command command = { REMOVE_COMPONENT, ComponentType::getId<T>(), entityId, nullptr };
+    commands.push_back(command);
+}
+
+template<typename T>
+void CommandBuffer::addComponentOfType(ComponentManager& componentManager, unsigned entityId){
+    componentManager.addComponent<T>(entityId);
+}
+
+#endif // COMMANDBUFFER_H
@@ -1,10 +1,23 @@
 #include "Entity.h"
 
-Entity::Entity()
+Entity::Entity() : id(Engine::entityManager.create())
 {
     //ctor
 }
 
+Entity::Entity(unsigned id) : id(id)
+{
+
+}
+
 unsigned Entity::getId() const{
     return id;
 }
+
+void Entity::destroy(){
+    Engine::entityManager.destroy(id);
+}
+
+bool Entity::isAlive() const{
+    return Engine::entityManager.isAlive(id);
+}
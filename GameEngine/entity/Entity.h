@@ -4,20 +4,35 @@
 #include "../core/Engine.h"
 #include "../components/Component.h"
 
+// A lightweight handle to an entity registered in the engine's entity manager.
+// Copies refer to the same entity. The entity lives until destroy() is called.
 class Entity
 {
 
 public:
+
+    // Creates a new entity.
     Entity();
 
+    // Refers to an existing entity.
+    explicit Entity(unsigned id);
+
     unsigned getId() const;
 
+    // Destroys the entity and all of its components.
+    void destroy();
+    bool isAlive() const;
+
+    // Returns nullptr if the entity was destroyed.
     template<typename T>
     T* addComponent();
 
     template<typename T>
     T* getComponent();
 
+    template<typename T>
+    void removeComponent();
+
 protected:
 
 private:
@@ -27,6 +42,9 @@ private:
 
 template<typename T>
 T* Entity::addComponent(){
+    if (!isAlive())
+        return nullptr;
+
     return Engine::componentManager.addComponent<T>(id);
 }
 
@@ -35,4 +53,10 @@ T* Entity::getComponent(){
     return Engine::componentManager.getComponent<T>(id);
 }
 
+template<typename T>
+void Entity::removeComponent(){
+    if (isAlive())
+        Engine::componentManager.removeComponent<T>(id);
+}
+
 #endif // ENTITY_H
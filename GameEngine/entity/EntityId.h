@@ -0,0 +1,34 @@
+/*
+    An entity id packs two values: the index of the slot the entity occupies,
+    and the generation of that slot. The generation is bumped every time the
+    slot is recycled so stale ids of destroyed entities can be detected.
+*/
+
+#ifndef ENTITYID_H
+#define ENTITYID_H
+
+constexpr unsigned ENTITY_INDEX_BITS = 20;
+constexpr unsigned ENTITY_GENERATION_BITS = 12;
+
+constexpr unsigned ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr unsigned ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
+// The maximum number of entities that can be alive at the same time.
+constexpr unsigned MAX_ENTITIES = ENTITY_INDEX_MASK;
+
+// An id that never refers to an entity.
+constexpr unsigned INVALID_ENTITY = 0xFFFFFFFF;
+
+inline unsigned getEntityIndex(unsigned entityId){
+    return entityId & ENTITY_INDEX_MASK;
+}
+
+inline unsigned getEntityGeneration(unsigned entityId){
+    return (entityId >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+inline unsigned makeEntityId(unsigned index, unsigned generation){
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
+#endif // ENTITYID_H
@@ -0,0 +1,93 @@
+#include "EntityManager.h"
+
+#include <iostream>
+
+using std::cerr;
+
+EntityManager::EntityManager(ComponentManager& componentManager) :
+    componentManager(componentManager)
+{
+    //ctor
+}
+
+unsigned EntityManager::create(){
+
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned index;
+
+    // Recycle a slot of a destroyed entity
+    if (!freeIndices.empty()){
+        index = freeIndices.front();
+        freeIndices.pop_front();
+    }
+
+    // Open a new slot
+    else{
+        index = generations.size();
+
+        if (index >= MAX_ENTITIES){
+            cerr << "Error. Unable to create entity, the limit of " << MAX_ENTITIES << " entities was reached.\n";
+            return INVALID_ENTITY;
+        }
+
+        generations.push_back(0);
+    }
+
+    return makeEntityId(index, generations[index]);
+}
+
+bool EntityManager::isAlive(unsigned entityId) const{
+    std::lock_guard<std::mutex> lock(mutex);
+    return isAliveUnlocked(entityId);
+}
+
+bool EntityManager::isAliveUnlocked(unsigned entityId) const{
+    unsigned index = getEntityIndex(entityId);
+    return entityId != INVALID_ENTITY && index < generations.size() && generations[index] == getEntityGeneration(entityId);
+}
+
+void EntityManager::destroy(unsigned entityId){
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isAliveUnlocked(entityId))
+        return;
+
+    componentManager.removeAllComponents(&entityId, 1);
+    releaseSlot(entityId);
+}
+
+void EntityManager::destroyAll(const unsigned* entityIds, unsigned count){
+
+    // Only pass live entities on to the component manager.
+    vector<unsigned> alive;
+    alive.reserve(count);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (unsigned i = 0; i < count; i++){
+        if (isAliveUnlocked(entityIds[i])){
+            alive.push_back(entityIds[i]);
+
+            // Release right away so duplicates in the list are skipped.
+            releaseSlot(entityIds[i]);
+        }
+    }
+
+    if (!alive.empty())
+        componentManager.removeAllComponents(&alive[0], alive.size());
+}
+
+void EntityManager::destroyAll(const vector<unsigned>& entityIds){
+    if (!entityIds.empty())
+        destroyAll(&entityIds[0], entityIds.size());
+}
+
+unsigned EntityManager::getAliveCount() const{
+    std::lock_guard<std::mutex> lock(mutex);
+    return generations.size() - freeIndices.size();
+}
+
+void EntityManager::releaseSlot(unsigned entityId){
+    unsigned index = getEntityIndex(entityId);
+    generations[index] = (generations[index] + 1) & ENTITY_GENERATION_MASK;
+    freeIndices.push_back(index);
+}
@@ -0,0 +1,59 @@
+#ifndef ENTITYMANAGER_H
+#define ENTITYMANAGER_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+
+#include "EntityId.h"
+#include "../components/ComponentManager.h"
+
+using std::vector;
+using std::deque;
+
+// Creates and destroys entities.
+// Slots of destroyed entities are recycled with a bumped generation so the
+// memory used by entities and component pools stays bounded.
+// The entity registry is guarded so ids can be created from any thread.
+// Components of other threads' entities should go through a CommandBuffer.
+class EntityManager
+{
+public:
+    EntityManager(ComponentManager&);
+
+    // Returns the id of a new entity, or INVALID_ENTITY if the limit is reached.
+    unsigned create();
+
+    // Returns true if the id refers to an entity that has not been destroyed.
+    bool isAlive(unsigned entityId) const;
+
+    // Destroys the entity and releases all of its components.
+    void destroy(unsigned entityId);
+
+    // Destroys many entities at once. Components are released pool by pool.
+    void destroyAll(const unsigned* entityIds, unsigned count);
+    void destroyAll(const vector<unsigned>& entityIds);
+
+    // The number of entities currently alive.
+    unsigned getAliveCount() const;
+
+private:
+
+    bool isAliveUnlocked(unsigned entityId) const;
+
+    // Marks the slot of the entity as free and bumps its generation.
+    void releaseSlot(unsigned entityId);
+
+    ComponentManager& componentManager;
+
+    // The current generation of each entity slot.
+    vector<unsigned> generations;
+
+    // Slots that can be recycled. The oldest freed slot is reused first
+    // so each slot goes as long as possible before its generation wraps.
+    deque<unsigned> freeIndices;
+
+    mutable std::mutex mutex;
+};
+
+#endif // ENTITYMANAGER_H
@@ -0,0 +1,30 @@
+#include "AABB.h"
+
+#include <limits>
+
+AABB::AABB() :
+    min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+    max(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max())
+{}
+
+AABB::AABB(const Vector3& min, const Vector3& max) : min(min), max(max)
+{}
+
+void AABB::expand(const Vector3& point){
+    for (unsigned i = 0; i < 3; i++){
+        if (point[i] < min[i]) min[i] = point[i];
+        if (point[i] > max[i]) max[i] = point[i];
+    }
+}
+
+bool AABB::isEmpty() const{
+    return min.x > max.x;
+}
+
+Vector3 AABB::getCenter() const{
+    return (min + max) * 0.5f;
+}
+
+Vector3 AABB::getExtents() const{
+    return (max - min) * 0.5f;
+}
@@ -0,0 +1,30 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include "Vector3.h"
+
+// An axis aligned bounding box.
+class AABB
+{
+public:
+
+    // An empty box, which any point expands.
+    AABB();
+    AABB(const Vector3& min, const Vector3& max);
+
+    // Grow the box to contain the point.
+    void expand(const Vector3& point);
+
+    // Returns true if no point was added to the box.
+    bool isEmpty() const;
+
+    Vector3 getCenter() const;
+
+    // Half the size of the box on every axis.
+    Vector3 getExtents() const;
+
+    Vector3 min;
+    Vector3 max;
+};
+
+#endif // AABB_H
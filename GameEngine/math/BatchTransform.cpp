@@ -0,0 +1,217 @@
+#include "BatchTransform.h"
+#include "Matrix4Kernels.h"
+#include "SIMD.h"
+#include "../core/JobSystem.h"
+
+#include <cmath>
+
+// Smaller batches run on the calling thread, splitting them costs more than it saves.
+static const unsigned PARALLEL_BATCH_SIZE = 4096;
+static const unsigned PARALLEL_GRAIN_SIZE = 1024;
+
+// Runs func(first, last) over the batch, split over the job system if there is one.
+template<typename Func>
+static void runBatch(unsigned count, JobSystem* jobSystem, Func func){
+    if (jobSystem && count >= PARALLEL_BATCH_SIZE)
+        jobSystem->parallelFor(0, count, PARALLEL_GRAIN_SIZE, func);
+    else
+        func(0, count);
+}
+
+#if defined(MATH_SSE2)
+
+// The columns of the matrix, so a transform is a sum of columns scaled by the vector.
+struct MatrixColumns{
+    MatrixColumns(const Matrix4& m){
+        for (unsigned col = 0; col < 4; col++)
+            columns[col] = _mm_setr_ps(m[0][col], m[1][col], m[2][col], m[3][col]);
+    }
+    __m128 columns[4];
+};
+
+// Stores the first three lanes.
+static inline void storeVector3(float* destination, __m128 v){
+    _mm_storel_pi(reinterpret_cast<__m64*>(destination), v);
+    _mm_store_ss(destination + 2, _mm_movehl_ps(v, v));
+}
+
+static inline __m128 transformVector3(const MatrixColumns& m, const float* v, __m128 w){
+    __m128 sum = _mm_add_ps(_mm_mul_ps(m.columns[0], _mm_set1_ps(v[0])), _mm_mul_ps(m.columns[1], _mm_set1_ps(v[1])));
+    return _mm_add_ps(_mm_add_ps(sum, _mm_mul_ps(m.columns[2], _mm_set1_ps(v[2]))), w);
+}
+
+#endif // MATH_SSE2
+
+static void transformPointRange(const Matrix4& m, const Vector3* points, Vector3* result, unsigned first, unsigned last){
+
+#if defined(MATH_SSE2)
+    MatrixColumns columns(m);
+    for (unsigned i = first; i < last; i++)
+        storeVector3(result[i].components, transformVector3(columns, points[i].components, columns.columns[3]));
+#else
+    for (unsigned i = first; i < last; i++){
+        Vector3 p = points[i];
+        for (unsigned row = 0; row < 3; row++)
+            result[i][row] = m[row][0] * p[0] + m[row][1] * p[1] + m[row][2] * p[2] + m[row][3];
+    }
+#endif
+}
+
+static void transformDirectionRange(const Matrix4& m, const Vector3* directions, Vector3* result, unsigned first, unsigned last){
+
+#if defined(MATH_SSE2)
+    MatrixColumns columns(m);
+    __m128 zero = _mm_setzero_ps();
+    for (unsigned i = first; i < last; i++)
+        storeVector3(result[i].components, transformVector3(columns, directions[i].components, zero));
+#else
+    for (unsigned i = first; i < last; i++){
+        Vector3 d = directions[i];
+        for (unsigned row = 0; row < 3; row++)
+            result[i][row] = m[row][0] * d[0] + m[row][1] * d[1] + m[row][2] * d[2];
+    }
+#endif
+}
+
+static void transformSoARange(const Matrix4& m, const float* x, const float* y, const float* z,
+                              float* resultX, float* resultY, float* resultZ, unsigned first, unsigned last){
+    unsigned i = first;
+
+#if defined(MATH_SSE2)
+    __m128 elements[3][4];
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 4; col++)
+            elements[row][col] = _mm_set1_ps(m[row][col]);
+
+    // Four points per iteration, one per lane.
+    for (; i + 4 <= last; i += 4){
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+
+        __m128 out[3];
+        for (unsigned row = 0; row < 3; row++){
+            __m128 sum = _mm_add_ps(_mm_mul_ps(elements[row][0], px), _mm_mul_ps(elements[row][1], py));
+            out[row] = _mm_add_ps(_mm_add_ps(sum, _mm_mul_ps(elements[row][2], pz)), elements[row][3]);
+        }
+
+        _mm_storeu_ps(resultX + i, out[0]);
+        _mm_storeu_ps(resultY + i, out[1]);
+        _mm_storeu_ps(resultZ + i, out[2]);
+    }
+#endif
+
+    // The remaining points.
+    for (; i < last; i++){
+        float px = x[i], py = y[i], pz = z[i];
+        resultX[i] = m[0][0] * px + m[0][1] * py + m[0][2] * pz + m[0][3];
+        resultY[i] = m[1][0] * px + m[1][1] * py + m[1][2] * pz + m[1][3];
+        resultZ[i] = m[2][0] * px + m[2][1] * py + m[2][2] * pz + m[2][3];
+    }
+}
+
+// Transforms the center, and takes the absolute matrix to transform the extents
+// (Arvo's method), instead of transforming all eight corners.
+static void transformAABBRange(const Matrix4& m, const AABB* boxes, AABB* result, unsigned first, unsigned last){
+
+#if defined(MATH_SSE2)
+    MatrixColumns columns(m);
+
+    // The columns without their sign bits.
+    MatrixColumns absColumns(m);
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    for (unsigned col = 0; col < 3; col++)
+        absColumns.columns[col] = _mm_andnot_ps(signMask, absColumns.columns[col]);
+
+    __m128 zero = _mm_setzero_ps();
+#endif
+
+    for (unsigned i = first; i < last; i++){
+
+        // Empty boxes stay empty.
+        if (boxes[i].isEmpty()){
+            result[i] = boxes[i];
+            continue;
+        }
+
+        Vector3 center = boxes[i].getCenter();
+        Vector3 extents = boxes[i].getExtents();
+
+#if defined(MATH_SSE2)
+        __m128 newCenter = transformVector3(columns, center.components, columns.columns[3]);
+        __m128 newExtents = transformVector3(absColumns, extents.components, zero);
+
+        storeVector3(result[i].min.components, _mm_sub_ps(newCenter, newExtents));
+        storeVector3(result[i].max.components, _mm_add_ps(newCenter, newExtents));
+#else
+        Vector3 newCenter, newExtents;
+        for (unsigned row = 0; row < 3; row++){
+            newCenter[row] = m[row][0] * center[0] + m[row][1] * center[1] + m[row][2] * center[2] + m[row][3];
+            newExtents[row] = std::abs(m[row][0]) * extents[0] + std::abs(m[row][1]) * extents[1] + std::abs(m[row][2]) * extents[2];
+        }
+
+        result[i].min = newCenter - newExtents;
+        result[i].max = newCenter + newExtents;
+#endif
+    }
+}
+
+void transformPoints(const Matrix4& m, const Vector3* points, Vector3* result, unsigned count, JobSystem* jobSystem){
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        transformPointRange(m, points, result, first, last);
+    });
+}
+
+void transformPoints(const Matrix4& m, const Vector4* points, Vector4* result, unsigned count, JobSystem* jobSystem){
+    const Matrix4Kernels& kernels = getMatrix4Kernels();
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        // Copied first, the scalar kernel can not write over its operand.
+        for (unsigned i = first; i < last; i++){
+            Vector4 point = points[i];
+            kernels.transform(m.getFirstAddr(), point.components, result[i].components);
+        }
+    });
+}
+
+void transformDirections(const Matrix4& m, const Vector3* directions, Vector3* result, unsigned count, JobSystem* jobSystem){
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        transformDirectionRange(m, directions, result, first, last);
+    });
+}
+
+void transformPoints(const Matrix4& m, const float* x, const float* y, const float* z,
+                     float* resultX, float* resultY, float* resultZ, unsigned count, JobSystem* jobSystem){
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        transformSoARange(m, x, y, z, resultX, resultY, resultZ, first, last);
+    });
+}
+
+void transformAABBs(const Matrix4& m, const AABB* boxes, AABB* result, unsigned count, JobSystem* jobSystem){
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        transformAABBRange(m, boxes, result, first, last);
+    });
+}
+
+void mulMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, unsigned count, JobSystem* jobSystem){
+    const Matrix4Kernels& kernels = getMatrix4Kernels();
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+
+        // The kernel can not write over its operands.
+        Matrix4 product;
+        for (unsigned i = first; i < last; i++){
+            kernels.multiply(a[i].getFirstAddr(), b[i].getFirstAddr(), &product.elements[0][0]);
+            result[i] = product;
+        }
+    });
+}
+
+void mulMatrices(const Matrix4& a, const Matrix4* b, Matrix4* result, unsigned count, JobSystem* jobSystem){
+    const Matrix4Kernels& kernels = getMatrix4Kernels();
+    runBatch(count, jobSystem, [&](unsigned first, unsigned last){
+        Matrix4 product;
+        for (unsigned i = first; i < last; i++){
+            kernels.multiply(a.getFirstAddr(), b[i].getFirstAddr(), &product.elements[0][0]);
+            result[i] = product;
+        }
+    });
+}
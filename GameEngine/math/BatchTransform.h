@@ -0,0 +1,41 @@
+/*
+    Transforms whole arrays by one matrix at a time.
+    Every kernel takes an optional job system: large batches are then split over
+    its threads. The input and output arrays may be the same array, but must not
+    otherwise overlap.
+*/
+
+#ifndef BATCHTRANSFORM_H
+#define BATCHTRANSFORM_H
+
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "AABB.h"
+
+class JobSystem;
+
+// Points with w = 1. The matrix must be affine (last row 0, 0, 0, 1).
+void transformPoints(const Matrix4& m, const Vector3* points, Vector3* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+// Points or vectors with their own w, e.g. for a projection.
+void transformPoints(const Matrix4& m, const Vector4* points, Vector4* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+// Directions (w = 0) are only rotated and scaled, never translated.
+void transformDirections(const Matrix4& m, const Vector3* directions, Vector3* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+// Points stored as separate x, y and z arrays (structure of arrays), which
+// transform four at a time. The matrix must be affine.
+void transformPoints(const Matrix4& m, const float* x, const float* y, const float* z,
+                     float* resultX, float* resultY, float* resultZ, unsigned count, JobSystem* jobSystem = nullptr);
+
+// The smallest boxes that contain the transformed boxes. The matrix must be affine.
+void transformAABBs(const Matrix4& m, const AABB* boxes, AABB* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+// result[i] = a[i] * b[i]
+void mulMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+// result[i] = a * b[i], e.g. a parent transform applied to its children.
+void mulMatrices(const Matrix4& a, const Matrix4* b, Matrix4* result, unsigned count, JobSystem* jobSystem = nullptr);
+
+#endif // BATCHTRANSFORM_H
@@ -9,8 +9,6 @@ class Matrix2 : public SquareMatrix<2>
 public:
     Matrix2();
     Matrix2(const SquareMatrix<2>&);
-
-    float determinant() const;
 };
 
 typedef SquareMatrix<2> Mat2;
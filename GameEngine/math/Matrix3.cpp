@@ -13,24 +13,6 @@ Matrix3::Matrix3(const SquareMatrix<3>& other){
             elements[row][col] = other[row][col];
 }
 
-float Matrix3::determinant() const{
-    float a, b, c, d, e, f, g, h, i;
-    a = elements[0][0];
-    b = elements[0][1];
-    c = elements[0][2];
-
-    d = elements[1][0];
-    e = elements[1][1];
-    f = elements[1][2];
-
-    g = elements[2][0];
-    h = elements[2][1];
-    i = elements[2][2];
-
-    return (a*e*i) - (a*f*h) - (b*d*i) + (b*f*g) + (c*d*h) - (c*e*g);
-}
-
-
 Matrix3 Matrix3::translation(const Vector2& translation){
     Matrix3 tmp;
     tmp.setElement(0, 2, translation.x);
@@ -13,8 +13,6 @@ public:
     Matrix3();
     Matrix3(const SquareMatrix<3>&);
 
-    float determinant() const;
-
     /* Transformation matrices for 2D operations */
 
     // Obtains a translation matrix for 2D transformations.
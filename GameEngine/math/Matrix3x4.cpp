@@ -0,0 +1,101 @@
+#include "Matrix3x4.h"
+
+Matrix3x4::Matrix3x4(){
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 4; col++)
+            elements[row][col] = row == col ? 1 : 0;
+}
+
+Matrix3x4::Matrix3x4(const Matrix4& m){
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 4; col++)
+            elements[row][col] = m[row][col];
+}
+
+Matrix3x4 Matrix3x4::fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale){
+
+    // The rotation matrix of the quaternion (see Quaternion::toMatrix()).
+    float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+    float rot[3][3] = {
+        { 1 - 2*(y*y + z*z),   2*(x*y - w*z),       2*(x*z + w*y)     },
+        { 2*(x*y + w*z),       1 - 2*(x*x + z*z),   2*(y*z - w*x)     },
+        { 2*(x*z - w*y),       2*(y*z + w*x),       1 - 2*(x*x + y*y) }
+    };
+
+    // Scaling first scales the columns of the rotation.
+    Matrix3x4 tmp;
+    for (unsigned row = 0; row < 3; row++){
+        for (unsigned col = 0; col < 3; col++)
+            tmp.elements[row][col] = rot[row][col] * scale[col];
+
+        tmp.elements[row][3] = translation[row];
+    }
+    return tmp;
+}
+
+Matrix4 Matrix3x4::toMatrix4() const{
+    Matrix4 tmp;
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 4; col++)
+            tmp[row][col] = elements[row][col];
+
+    // The last row is left to the identity's (0, 0, 0, 1).
+    return tmp;
+}
+
+Vector3 Matrix3x4::transformPoint(const Vector3& p) const{
+    Vector3 tmp;
+    for (unsigned row = 0; row < 3; row++)
+        tmp[row] = elements[row][0] * p.x + elements[row][1] * p.y + elements[row][2] * p.z + elements[row][3];
+    return tmp;
+}
+
+Vector3 Matrix3x4::transformDirection(const Vector3& d) const{
+    Vector3 tmp;
+    for (unsigned row = 0; row < 3; row++)
+        tmp[row] = elements[row][0] * d.x + elements[row][1] * d.y + elements[row][2] * d.z;
+    return tmp;
+}
+
+Vector3 Matrix3x4::getTranslation() const{
+    return Vector3(elements[0][3], elements[1][3], elements[2][3]);
+}
+
+Matrix3x4 Matrix3x4::operator*(const Matrix3x4& other) const{
+    Matrix3x4 tmp;
+    for (unsigned row = 0; row < 3; row++){
+        const float* r = elements[row];
+
+        for (unsigned col = 0; col < 4; col++)
+            tmp.elements[row][col] = r[0] * other[0][col] + r[1] * other[1][col] + r[2] * other[2][col];
+
+        // The implicit (0, 0, 0, 1) row of the other matrix only adds our translation.
+        tmp.elements[row][3] += r[3];
+    }
+    return tmp;
+}
+
+const Matrix3x4& Matrix3x4::operator*=(const Matrix3x4& other){
+    *this = *this * other;
+    return *this;
+}
+
+bool Matrix3x4::operator==(const Matrix3x4& other) const{
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 4; col++)
+            if (elements[row][col] != other[row][col])
+                return false;
+    return true;
+}
+
+bool Matrix3x4::operator!=(const Matrix3x4& other) const{
+    return !(*this == other);
+}
+
+float* Matrix3x4::operator[](int index){
+    return elements[index];
+}
+
+const float* Matrix3x4::operator[](int index) const{
+    return elements[index];
+}
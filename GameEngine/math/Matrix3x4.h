@@ -0,0 +1,49 @@
+#ifndef MATRIX3X4_H
+#define MATRIX3X4_H
+
+#include "Vector3.h"
+#include "Matrix4.h"
+#include "Quaternion.h"
+
+/**
+    An affine transformation: the top three rows of a 4x4 matrix whose last row
+    is always (0, 0, 0, 1). It takes 12 floats instead of 16, and multiplying two
+    of them skips the work of the last row.
+*/
+
+class Matrix3x4
+{
+public:
+    // The identity transformation.
+    Matrix3x4();
+
+    // Drops the last row, which must be (0, 0, 0, 1).
+    explicit Matrix3x4(const Matrix4&);
+
+    // Compose translation * rotation * scale directly, without multiplying matrices.
+    static Matrix3x4 fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
+    // Expand to a full matrix, e.g. to upload it to a shader.
+    Matrix4 toMatrix4() const;
+
+    Vector3 transformPoint(const Vector3&) const;
+    Vector3 transformDirection(const Vector3&) const;
+
+    Vector3 getTranslation() const;
+
+    Matrix3x4 operator*(const Matrix3x4&) const;
+    const Matrix3x4& operator*=(const Matrix3x4&);
+
+    bool operator==(const Matrix3x4&) const;
+    bool operator!=(const Matrix3x4&) const;
+
+    float* operator[](int index);
+    const float* operator[](int index) const;
+
+    float elements[3][4];
+};
+
+typedef Matrix3x4 Mat3x4;
+typedef Matrix3x4 mat3x4;
+
+#endif // MATRIX3X4_H
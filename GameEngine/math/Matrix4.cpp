@@ -13,34 +13,46 @@ Matrix4::Matrix4(const SquareMatrix<4>& other){
             elements[row][col] = other[row][col];
 }
 
-float Matrix4::determinant() const{
-    float a, b, c, d, e, f, g, h, i, j, k, l, m, n, o ,p;
-    a = elements[0][0];
-    b = elements[0][1];
-    c = elements[0][2];
-    d = elements[0][3];
-
-    e = elements[1][0];
-    f = elements[1][1];
-    g = elements[1][2];
-    h = elements[1][3];
-
-    i = elements[2][0];
-    j = elements[2][1];
-    k = elements[2][2];
-    l = elements[2][3];
-
-    m = elements[3][0];
-    n = elements[3][1];
-    o = elements[3][2];
-    p = elements[3][3];
-
-    return (a*f*k*p) - (a*f*l*o) - (a*g*j*p) + (a*g*l*n) + (a*h*j*o) - (a*h*k*n)
-          -(b*e*k*p) + (b*e*l*o) + (b*g*i*p) - (b*g*l*m) - (b*h*i*o) + (b*h*k*m)
-          +c*( (e*j*p) - (e*l*n) - (f*i*p)+ (f*l*m) + (h*i*n) - (h*j*m))
-          +d*( (-e*j*o) + (e*k*n) + (f*i*o) - (f*k*m) - (g*i*n) + (g*j*m));
+Matrix4 Matrix4::affineInverse() const{
+
+    SquareMatrix<3> linear;
+    for (unsigned row = 0; row < 3; row++)
+        for (unsigned col = 0; col < 3; col++)
+            linear[row][col] = elements[row][col];
+
+    // Not invertible
+    if (linear.determinant() == 0)
+        return Matrix4();
+
+    SquareMatrix<3> inverse = linear.inverse();
+
+    // The inverse translation is the translation undone by the inverse linear part.
+    Matrix4 tmp;
+    for (unsigned row = 0; row < 3; row++){
+        for (unsigned col = 0; col < 3; col++)
+            tmp.elements[row][col] = inverse[row][col];
+
+        tmp.elements[row][3] = -(inverse[row][0] * elements[0][3] +
+                                 inverse[row][1] * elements[1][3] +
+                                 inverse[row][2] * elements[2][3]);
+    }
+    return tmp;
 }
 
+Matrix4 Matrix4::rigidInverse() const{
+
+    Matrix4 tmp;
+    for (unsigned row = 0; row < 3; row++){
+        for (unsigned col = 0; col < 3; col++)
+            tmp.elements[row][col] = elements[col][row];
+
+        // The translation rotated back: -transpose(R) * t
+        tmp.elements[row][3] = -(elements[0][row] * elements[0][3] +
+                                 elements[1][row] * elements[1][3] +
+                                 elements[2][row] * elements[2][3]);
+    }
+    return tmp;
+}
 
 Matrix4 Matrix4::translation(const Vector3& v){
     Matrix4 tmp;
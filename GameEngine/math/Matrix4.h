@@ -10,7 +10,13 @@ public:
     Matrix4();
     Matrix4(const SquareMatrix<4>&);
 
-    float determinant() const;
+    // Inverse of a matrix whose last row is (0, 0, 0, 1), e.g. any combination of
+    // translations, rotations, scales and shears. Only a 3x3 inverse is needed.
+    Matrix4 affineInverse() const;
+
+    // Inverse of a matrix made of only a rotation and a translation, e.g. a camera
+    // or bone transform. The rotation is inverted by transposing it.
+    Matrix4 rigidInverse() const;
 
     /* Transformation matrices for 3D operations */
     static Matrix4 translation(const Vector3&);
@@ -0,0 +1,272 @@
+#include "Matrix4Kernels.h"
+
+// ============================== SCALAR ==============================
+
+static void multiplyScalar(const float* a, const float* b, float* result){
+    for (unsigned row = 0; row < 4; row++){
+        const float* r = a + row * 4;
+        for (unsigned col = 0; col < 4; col++)
+            result[row * 4 + col] = r[0] * b[col] + r[1] * b[4 + col] + r[2] * b[8 + col] + r[3] * b[12 + col];
+    }
+}
+
+static void transformScalar(const float* m, const float* v, float* result){
+    for (unsigned row = 0; row < 4; row++){
+        const float* r = m + row * 4;
+        result[row] = r[0] * v[0] + r[1] * v[1] + r[2] * v[2] + r[3] * v[3];
+    }
+}
+
+static void transposeScalar(const float* m, float* result){
+    for (unsigned row = 0; row < 4; row++)
+        for (unsigned col = 0; col < 4; col++)
+            result[col * 4 + row] = m[row * 4 + col];
+}
+
+// Cramer's rule, sharing the 2x2 determinants of the top two and bottom two rows.
+static bool inverseScalar(const float* m, float* result){
+
+    float s0 = m[0] * m[5] - m[4] * m[1];
+    float s1 = m[0] * m[6] - m[4] * m[2];
+    float s2 = m[0] * m[7] - m[4] * m[3];
+    float s3 = m[1] * m[6] - m[5] * m[2];
+    float s4 = m[1] * m[7] - m[5] * m[3];
+    float s5 = m[2] * m[7] - m[6] * m[3];
+
+    float c5 = m[10] * m[15] - m[14] * m[11];
+    float c4 = m[9] * m[15] - m[13] * m[11];
+    float c3 = m[9] * m[14] - m[13] * m[10];
+    float c2 = m[8] * m[15] - m[12] * m[11];
+    float c1 = m[8] * m[14] - m[12] * m[10];
+    float c0 = m[8] * m[13] - m[12] * m[9];
+
+    float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (det == 0)
+        return false;
+
+    float invDet = 1 / det;
+
+    result[0] = ( m[5] * c5 - m[6] * c4 + m[7] * c3) * invDet;
+    result[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * invDet;
+    result[2] = ( m[13] * s5 - m[14] * s4 + m[15] * s3) * invDet;
+    result[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * invDet;
+
+    result[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * invDet;
+    result[5] = ( m[0] * c5 - m[2] * c2 + m[3] * c1) * invDet;
+    result[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * invDet;
+    result[7] = ( m[8] * s5 - m[10] * s2 + m[11] * s1) * invDet;
+
+    result[8] = ( m[4] * c4 - m[5] * c2 + m[7] * c0) * invDet;
+    result[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * invDet;
+    result[10] = ( m[12] * s4 - m[13] * s2 + m[15] * s0) * invDet;
+    result[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * invDet;
+
+    result[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * invDet;
+    result[13] = ( m[0] * c3 - m[1] * c1 + m[2] * c0) * invDet;
+    result[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * invDet;
+    result[15] = ( m[8] * s3 - m[9] * s1 + m[10] * s0) * invDet;
+
+    return true;
+}
+
+static const Matrix4Kernels scalarKernels = {
+    multiplyScalar, transformScalar, transposeScalar, inverseScalar
+};
+
+// ============================== SSE2 ==============================
+
+#if defined(MATH_SSE2)
+
+#define SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, SHUFFLE_MASK(x, y, z, w))
+#define SWIZZLE(a, x, y, z, w) SHUFFLE(a, a, x, y, z, w)
+
+static void multiplySSE2(const float* a, const float* b, float* result){
+
+    __m128 b0 = _mm_loadu_ps(b);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 b2 = _mm_loadu_ps(b + 8);
+    __m128 b3 = _mm_loadu_ps(b + 12);
+
+    // Each row of the result is a combination of the rows of b.
+    for (unsigned row = 0; row < 4; row++){
+        const float* r = a + row * 4;
+
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(r[0]), b0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(r[1]), b1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(r[2]), b2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(r[3]), b3));
+
+        _mm_storeu_ps(result + row * 4, sum);
+    }
+}
+
+static void transformSSE2(const float* m, const float* v, float* result){
+
+    __m128 vec = _mm_loadu_ps(v);
+    __m128 p0 = _mm_mul_ps(_mm_loadu_ps(m), vec);
+    __m128 p1 = _mm_mul_ps(_mm_loadu_ps(m + 4), vec);
+    __m128 p2 = _mm_mul_ps(_mm_loadu_ps(m + 8), vec);
+    __m128 p3 = _mm_mul_ps(_mm_loadu_ps(m + 12), vec);
+
+    // Transposing the products lets one vertical sum finish the four dot products.
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    _mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+}
+
+static void transposeSSE2(const float* m, float* result){
+
+    __m128 r0 = _mm_loadu_ps(m);
+    __m128 r1 = _mm_loadu_ps(m + 4);
+    __m128 r2 = _mm_loadu_ps(m + 8);
+    __m128 r3 = _mm_loadu_ps(m + 12);
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    _mm_storeu_ps(result, r0);
+    _mm_storeu_ps(result + 4, r1);
+    _mm_storeu_ps(result + 8, r2);
+    _mm_storeu_ps(result + 12, r3);
+}
+
+// The 2x2 helpers work on row-major 2x2 matrices held in one register.
+// A * B
+static inline __m128 multiply2x2(__m128 a, __m128 b){
+    return _mm_add_ps(_mm_mul_ps(a, SWIZZLE(b, 0, 3, 0, 3)),
+                      _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adjugate(A) * B
+static inline __m128 adjugateMultiply2x2(__m128 a, __m128 b){
+    return _mm_sub_ps(_mm_mul_ps(SWIZZLE(a, 3, 3, 0, 0), b),
+                      _mm_mul_ps(SWIZZLE(a, 1, 1, 2, 2), SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adjugate(B)
+static inline __m128 multiplyAdjugate2x2(__m128 a, __m128 b){
+    return _mm_sub_ps(_mm_mul_ps(a, SWIZZLE(b, 3, 0, 3, 0)),
+                      _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// Inverts the matrix as 2x2 blocks | A B |
+//                                  | C D |
+static bool inverseSSE2(const float* m, float* result){
+
+    __m128 r0 = _mm_loadu_ps(m);
+    __m128 r1 = _mm_loadu_ps(m + 4);
+    __m128 r2 = _mm_loadu_ps(m + 8);
+    __m128 r3 = _mm_loadu_ps(m + 12);
+
+    __m128 a = _mm_movelh_ps(r0, r1);
+    __m128 b = _mm_movehl_ps(r1, r0);
+    __m128 c = _mm_movelh_ps(r2, r3);
+    __m128 d = _mm_movehl_ps(r3, r2);
+
+    // The determinants of the blocks, (|A|, |B|, |C|, |D|).
+    __m128 blockDets = _mm_sub_ps(
+        _mm_mul_ps(SHUFFLE(r0, r2, 0, 2, 0, 2), SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(SHUFFLE(r0, r2, 1, 3, 1, 3), SHUFFLE(r1, r3, 0, 2, 0, 2)));
+
+    __m128 detA = SWIZZLE(blockDets, 0, 0, 0, 0);
+    __m128 detB = SWIZZLE(blockDets, 1, 1, 1, 1);
+    __m128 detC = SWIZZLE(blockDets, 2, 2, 2, 2);
+    __m128 detD = SWIZZLE(blockDets, 3, 3, 3, 3);
+
+    __m128 adjDC = adjugateMultiply2x2(d, c);
+    __m128 adjAB = adjugateMultiply2x2(a, b);
+
+    // The inverse is 1/|M| * | X Y |, the blocks are built adjugated.
+    //                        | Z W |
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), multiply2x2(b, adjDC));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), multiply2x2(c, adjAB));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), multiplyAdjugate2x2(d, adjAB));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), multiplyAdjugate2x2(a, adjDC));
+
+    // |M| = |A||D| + |B||C| - trace(adjugate(A)B adjugate(D)C)
+    __m128 trace = _mm_mul_ps(adjAB, SWIZZLE(adjDC, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, SWIZZLE(trace, 2, 3, 0, 1));
+    trace = _mm_add_ps(trace, SWIZZLE(trace, 1, 0, 3, 2));
+
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+    if (_mm_cvtss_f32(det) == 0)
+        return false;
+
+    // Undo the adjugate while scaling: the adjugate of a 2x2 negates its off diagonal.
+    __m128 scale = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), det);
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    w = _mm_mul_ps(w, scale);
+
+    // Swapping the diagonals finishes the adjugates while storing the rows.
+    _mm_storeu_ps(result, SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(result + 4, SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(result + 8, SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(result + 12, SHUFFLE(z, w, 2, 0, 2, 0));
+
+    return true;
+}
+
+static const Matrix4Kernels sse2Kernels = {
+    multiplySSE2, transformSSE2, transposeSSE2, inverseSSE2
+};
+
+#endif // MATH_SSE2
+
+// ============================== AVX + FMA ==============================
+
+#if defined(MATH_AVX_FMA)
+
+// Computes two rows of the result at a time, one per 128 bit lane.
+MATH_TARGET_AVX_FMA
+static void multiplyAVXFMA(const float* a, const float* b, float* result){
+
+    // Every row of b in both lanes.
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+    for (unsigned row = 0; row < 4; row += 2){
+
+        // Rows 'row' and 'row + 1' of a, one per lane.
+        __m256 rows = _mm256_loadu_ps(a + row * 4);
+
+        __m256 sum = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), b0);
+        sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0x55), b1, sum);
+        sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xAA), b2, sum);
+        sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xFF), b3, sum);
+
+        _mm256_storeu_ps(result + row * 4, sum);
+    }
+}
+
+// The other operations are too small to gain from the wider registers.
+static const Matrix4Kernels avxFmaKernels = {
+    multiplyAVXFMA, transformSSE2, transposeSSE2, inverseSSE2
+};
+
+#endif // MATH_AVX_FMA
+
+const Matrix4Kernels& getMatrix4Kernels(){
+    static const Matrix4Kernels& kernels = getMatrix4Kernels(getSIMDLevel());
+    return kernels;
+}
+
+const Matrix4Kernels& getMatrix4Kernels(SIMDLevel level){
+
+    if (level > getSIMDLevel())
+        level = getSIMDLevel();
+
+#if defined(MATH_AVX_FMA)
+    if (level == SIMD_AVX_FMA)
+        return avxFmaKernels;
+#endif
+
+#if defined(MATH_SSE2)
+    if (level >= SIMD_SSE2)
+        return sse2Kernels;
+#endif
+
+    return scalarKernels;
+}
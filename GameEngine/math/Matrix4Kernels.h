@@ -0,0 +1,33 @@
+/*
+    The 4x4 matrix operations behind SquareMatrix<4>, on row-major arrays of 16 floats.
+    Every instruction set has its own version of each; the fastest one supported
+    by the processor is picked on first use.
+*/
+
+#ifndef MATRIX4KERNELS_H
+#define MATRIX4KERNELS_H
+
+#include "SIMD.h"
+
+struct Matrix4Kernels{
+
+    // result = a * b. The result may not be one of the operands.
+    void (*multiply)(const float* a, const float* b, float* result);
+
+    // result = m * v, with v a column vector of 4 floats.
+    void (*transform)(const float* m, const float* v, float* result);
+
+    void (*transpose)(const float* m, float* result);
+
+    // Returns false, leaving the result untouched, if the matrix is singular.
+    bool (*inverse)(const float* m, float* result);
+};
+
+// The kernels of the fastest supported instruction set.
+const Matrix4Kernels& getMatrix4Kernels();
+
+// The kernels of a given instruction set, e.g. to compare them. Falls back on
+// the best supported level below it.
+const Matrix4Kernels& getMatrix4Kernels(SIMDLevel level);
+
+#endif // MATRIX4KERNELS_H
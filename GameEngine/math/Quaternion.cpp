@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include "MathUtil.h"
+#include "SIMD.h"
 
 Quaternion::Quaternion(float w, float x, float y, float z) : w(w), x(x), y(y), z(z){}
 
@@ -38,6 +39,28 @@ void Quaternion::normalize(){
     z /= mag;
 }
 
+// One Newton-Raphson step refines the hardware estimate from 12 to about 22 bits.
+static inline float reciprocalSqrt(float value){
+#if defined(MATH_SSE2)
+    float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+    return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#else
+    return 1 / sqrtf(value);
+#endif
+}
+
+void Quaternion::fastNormalize(){
+    float invMag = reciprocalSqrt(sqMagnitude());
+    w *= invMag;
+    x *= invMag;
+    y *= invMag;
+    z *= invMag;
+}
+
+float Quaternion::dot(const Quaternion& q) const{
+    return w*q.w + x*q.x + y*q.y + z*q.z;
+}
+
 float Quaternion::magnitude() const{
     return sqrtf(w*w + x*x + y*y + z*z);
 }
@@ -160,6 +183,20 @@ int Quaternion::getGimbalPole() const{
     return 0;
 }
 */
+// The columns of the rotation matrix (see toMatrix()) are the rotated axes.
+QuaternionBasis Quaternion::getBasis() const{
+
+    float xx = x*x, yy = y*y, zz = z*z;
+    float xy = x*y, xz = x*z, yz = y*z;
+    float wx = w*x, wy = w*y, wz = w*z;
+
+    QuaternionBasis basis;
+    basis.right = Vector3(1 - 2*(yy + zz), 2*(xy + wz), 2*(xz - wy));
+    basis.up = Vector3(2*(xy - wz), 1 - 2*(xx + zz), 2*(yz + wx));
+    basis.forward = Vector3(2*(xz + wy), 2*(yz - wx), 1 - 2*(xx + yy));
+    return basis;
+}
+
 Vector3 Quaternion::getForward() const{
     return Quaternion::rotate(Vector3(0, 0, 1), *this);
 }
@@ -218,10 +255,9 @@ Quaternion Quaternion::operator+(const Quaternion& q) const{
 }
 
 const Quaternion& Quaternion::operator*=(const Quaternion& q){
-    w = w*q.w - x*q.x - y*q.y - z*q.z;
-    x = w*q.x + x*q.w + y*q.z - z*q.y;
-    y = w*q.y - x*q.z + y*q.w + z*q.x;
-    z = w*q.z + x*q.y - y*q.x + z*q.w;
+
+    // Every component needs the old values of the others.
+    *this = (*this) * q;
     return *this;
 }
 
@@ -256,6 +292,224 @@ Vector3 Quaternion::rotate(const Vector3& v, const Quaternion& q){
     return result.toVector().normal();
 }
 
+Quaternion Quaternion::slerp(const Quaternion& from, const Quaternion& to, float t){
+
+    // q and -q are the same rotation. Pick the one closer to 'from' for the shortest path.
+    float cosAngle = from.dot(to);
+    float sign = 1;
+    if (cosAngle < 0){
+        cosAngle = -cosAngle;
+        sign = -1;
+    }
+
+    // Nearly the same rotation. sin(angle) tends to 0, so fall back on nlerp.
+    if (cosAngle > 0.9995f)
+        return nlerp(from, to, t);
+
+    float angle = acosf(cosAngle);
+    float invSin = 1 / sinf(angle);
+    float fromWeight = sinf((1 - t) * angle) * invSin;
+    float toWeight = sinf(t * angle) * invSin * sign;
+
+    return Quaternion(from.w * fromWeight + to.w * toWeight,
+                      from.x * fromWeight + to.x * toWeight,
+                      from.y * fromWeight + to.y * toWeight,
+                      from.z * fromWeight + to.z * toWeight);
+}
+
+Quaternion Quaternion::nlerp(const Quaternion& from, const Quaternion& to, float t){
+
+    // Shortest path, see slerp().
+    float toWeight = from.dot(to) < 0 ? -t : t;
+    float fromWeight = 1 - t;
+
+    Quaternion tmp(from.w * fromWeight + to.w * toWeight,
+                   from.x * fromWeight + to.x * toWeight,
+                   from.y * fromWeight + to.y * toWeight,
+                   from.z * fromWeight + to.z * toWeight);
+    tmp.fastNormalize();
+    return tmp;
+}
+
+#if defined(MATH_SSE2)
+
+// Four quaternions with their w, x, y and z in separate registers.
+struct QuaternionLanes{
+    __m128 w, x, y, z;
+};
+
+static inline QuaternionLanes loadLanes(const Quaternion* q){
+    QuaternionLanes lanes;
+    lanes.w = _mm_loadu_ps(&q[0].w);
+    lanes.x = _mm_loadu_ps(&q[1].w);
+    lanes.y = _mm_loadu_ps(&q[2].w);
+    lanes.z = _mm_loadu_ps(&q[3].w);
+    _MM_TRANSPOSE4_PS(lanes.w, lanes.x, lanes.y, lanes.z);
+    return lanes;
+}
+
+static inline void storeLanes(Quaternion* q, QuaternionLanes lanes){
+    _MM_TRANSPOSE4_PS(lanes.w, lanes.x, lanes.y, lanes.z);
+    _mm_storeu_ps(&q[0].w, lanes.w);
+    _mm_storeu_ps(&q[1].w, lanes.x);
+    _mm_storeu_ps(&q[2].w, lanes.y);
+    _mm_storeu_ps(&q[3].w, lanes.z);
+}
+
+static inline void normalizeLanes(QuaternionLanes& q){
+    __m128 sqMag = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q.w, q.w), _mm_mul_ps(q.x, q.x)),
+                              _mm_add_ps(_mm_mul_ps(q.y, q.y), _mm_mul_ps(q.z, q.z)));
+
+    // See reciprocalSqrt().
+    __m128 estimate = _mm_rsqrt_ps(sqMag);
+    __m128 refine = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), sqMag), _mm_mul_ps(estimate, estimate)));
+    __m128 invMag = _mm_mul_ps(estimate, refine);
+
+    q.w = _mm_mul_ps(q.w, invMag);
+    q.x = _mm_mul_ps(q.x, invMag);
+    q.y = _mm_mul_ps(q.y, invMag);
+    q.z = _mm_mul_ps(q.z, invMag);
+}
+
+// acos(x) for x in [0, 1], within about 1e-7 (Abramowitz and Stegun 4.4.46).
+static inline __m128 acosLanes(__m128 x){
+    __m128 p = _mm_set1_ps(-0.0012624911f);
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0066700901f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.0170881256f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0308918810f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.0501743046f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0889789874f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.2145988016f));
+    p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.5707963050f));
+    return _mm_mul_ps(p, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1), x)));
+}
+
+// sin(x) for x in [0, pi/2], within about 1e-7: its Taylor series up to x^11.
+static inline __m128 sinLanes(__m128 x){
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_set1_ps(-1.0f / 39916800);
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 362880));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 5040));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 120));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 6));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1));
+    return _mm_mul_ps(p, x);
+}
+
+#endif // MATH_SSE2
+
+void Quaternion::slerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* result, unsigned count){
+    unsigned i = 0;
+
+#if defined(MATH_SSE2)
+    __m128 fromT = _mm_set1_ps(1 - t);
+    __m128 toT = _mm_set1_ps(t);
+    __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= count; i += 4){
+        QuaternionLanes a = loadLanes(from + i);
+        QuaternionLanes b = loadLanes(to + i);
+
+        // Same as slerp(), without branches: the shortest path, and nlerp where the
+        // rotations are nearly the same.
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.w, b.w), _mm_mul_ps(a.x, b.x)),
+                                _mm_add_ps(_mm_mul_ps(a.y, b.y), _mm_mul_ps(a.z, b.z)));
+        __m128 sign = _mm_and_ps(dot, signBit);
+        __m128 cosAngle = _mm_min_ps(_mm_xor_ps(dot, sign), _mm_set1_ps(1));
+
+        __m128 angle = acosLanes(cosAngle);
+        __m128 invSin = _mm_div_ps(_mm_set1_ps(1), sinLanes(angle));
+        __m128 fromWeight = _mm_mul_ps(sinLanes(_mm_mul_ps(fromT, angle)), invSin);
+        __m128 toWeight = _mm_mul_ps(sinLanes(_mm_mul_ps(toT, angle)), invSin);
+
+        __m128 near = _mm_cmpgt_ps(cosAngle, _mm_set1_ps(0.9995f));
+        fromWeight = _mm_or_ps(_mm_and_ps(near, fromT), _mm_andnot_ps(near, fromWeight));
+        toWeight = _mm_or_ps(_mm_and_ps(near, toT), _mm_andnot_ps(near, toWeight));
+        toWeight = _mm_xor_ps(toWeight, sign);
+
+        QuaternionLanes r;
+        r.w = _mm_add_ps(_mm_mul_ps(a.w, fromWeight), _mm_mul_ps(b.w, toWeight));
+        r.x = _mm_add_ps(_mm_mul_ps(a.x, fromWeight), _mm_mul_ps(b.x, toWeight));
+        r.y = _mm_add_ps(_mm_mul_ps(a.y, fromWeight), _mm_mul_ps(b.y, toWeight));
+        r.z = _mm_add_ps(_mm_mul_ps(a.z, fromWeight), _mm_mul_ps(b.z, toWeight));
+
+        // Only needed by the nlerp lanes, and keeps the error of the
+        // approximations from changing the length of the others.
+        normalizeLanes(r);
+        storeLanes(result + i, r);
+    }
+#endif
+
+    for (; i < count; i++)
+        result[i] = slerp(from[i], to[i], t);
+}
+
+void Quaternion::nlerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* result, unsigned count){
+    unsigned i = 0;
+
+#if defined(MATH_SSE2)
+    __m128 fromWeight = _mm_set1_ps(1 - t);
+    __m128 toWeight = _mm_set1_ps(t);
+    __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= count; i += 4){
+        QuaternionLanes a = loadLanes(from + i);
+        QuaternionLanes b = loadLanes(to + i);
+
+        // Flip the sign of the weight where the dot product is negative (shortest path).
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.w, b.w), _mm_mul_ps(a.x, b.x)),
+                                _mm_add_ps(_mm_mul_ps(a.y, b.y), _mm_mul_ps(a.z, b.z)));
+        __m128 weight = _mm_xor_ps(toWeight, _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), signBit));
+
+        QuaternionLanes r;
+        r.w = _mm_add_ps(_mm_mul_ps(a.w, fromWeight), _mm_mul_ps(b.w, weight));
+        r.x = _mm_add_ps(_mm_mul_ps(a.x, fromWeight), _mm_mul_ps(b.x, weight));
+        r.y = _mm_add_ps(_mm_mul_ps(a.y, fromWeight), _mm_mul_ps(b.y, weight));
+        r.z = _mm_add_ps(_mm_mul_ps(a.z, fromWeight), _mm_mul_ps(b.z, weight));
+
+        normalizeLanes(r);
+        storeLanes(result + i, r);
+    }
+#endif
+
+    for (; i < count; i++)
+        result[i] = nlerp(from[i], to[i], t);
+}
+
+void Quaternion::fastNormalize(Quaternion* quaternions, unsigned count){
+    unsigned i = 0;
+
+#if defined(MATH_SSE2)
+    for (; i + 4 <= count; i += 4){
+        QuaternionLanes q = loadLanes(quaternions + i);
+        normalizeLanes(q);
+        storeLanes(quaternions + i, q);
+    }
+#endif
+
+    for (; i < count; i++)
+        quaternions[i].fastNormalize();
+}
+
+void Quaternion::toMatrices(const Quaternion* quaternions, Matrix4* result, unsigned count){
+    for (unsigned i = 0; i < count; i++){
+        const Quaternion& q = quaternions[i];
+
+        float xx = q.x*q.x, yy = q.y*q.y, zz = q.z*q.z;
+        float xy = q.x*q.y, xz = q.x*q.z, yz = q.y*q.z;
+        float wx = q.w*q.x, wy = q.w*q.y, wz = q.w*q.z;
+
+        // The columns are the axes of getBasis(), written in place rather than
+        // through Vector3s, whose constructors can not be inlined here.
+        float (*m)[4] = result[i].elements;
+
+        m[0][0] = 1 - 2*(yy + zz);  m[0][1] = 2*(xy - wz);      m[0][2] = 2*(xz + wy);      m[0][3] = 0;
+        m[1][0] = 2*(xy + wz);      m[1][1] = 1 - 2*(xx + zz);  m[1][2] = 2*(yz - wx);      m[1][3] = 0;
+        m[2][0] = 2*(xz - wy);      m[2][1] = 2*(yz + wx);      m[2][2] = 1 - 2*(xx + yy);  m[2][3] = 0;
+        m[3][0] = 0;                m[3][1] = 0;                m[3][2] = 0;                m[3][3] = 1;
+    }
+}
+
 ostream& operator<<(ostream& os, const Quaternion& q){
     return os << "q: " << q.w << ", <" << q.x << ", " << q.y << ", " << q.z << ">";
 }
@@ -15,6 +15,13 @@
 
 using std::ostream;
 
+// The axes of a rotated frame, see Quaternion::getBasis().
+struct QuaternionBasis{
+    Vector3 right;
+    Vector3 up;
+    Vector3 forward;
+};
+
 class Quaternion{
 
 friend ostream& operator<<(ostream& os, const Quaternion&);
@@ -38,6 +45,12 @@ public:
     void normalize();
     float magnitude() const;
 
+    // Normalize with an approximate reciprocal square root, precise to about 1e-6.
+    // Meant for quaternions that are already close to unit length.
+    void fastNormalize();
+
+    float dot(const Quaternion&) const;
+
     // The squared magnitude of the quaternion
     float sqMagnitude() const;
     void conjugate();
@@ -70,6 +83,8 @@ public:
 */
 
     // Obtain directional vectors relative to the quaternion rotation.
+    // getBasis() computes the right, up and forward vectors together, for a unit quaternion.
+    QuaternionBasis getBasis() const;
     Vector3 getForward() const;
     Vector3 getBack() const;
     Vector3 getUp() const;
@@ -98,8 +113,24 @@ public:
     // Rotate the vector about the quaternion by interpreting the vector as a unit quaternion
     static Vector3 rotate(const Vector3&, const Quaternion&);
 
+    // Interpolate between two unit quaternions along the shortest path, t in [0, 1].
+    // Slerp turns at a constant rate. Nlerp is cheaper, but turns faster in the middle.
+    static Quaternion slerp(const Quaternion& from, const Quaternion& to, float t);
+    static Quaternion nlerp(const Quaternion& from, const Quaternion& to, float t);
+
+    // The same operations over arrays, e.g. every bone of a skeleton.
+    // The result may be one of the input arrays. The batch slerp approximates the
+    // trigonometry with polynomials, within about 1e-6 of slerp().
+    static void slerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* result, unsigned count);
+    static void nlerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* result, unsigned count);
+    static void fastNormalize(Quaternion* quaternions, unsigned count);
+    static void toMatrices(const Quaternion* quaternions, Matrix4* result, unsigned count);
+
 //private:
     float w, x, y, z;
 };
 
+// Batches are loaded straight into SIMD registers.
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be 4 packed floats");
+
 #endif // QUATERNION_H
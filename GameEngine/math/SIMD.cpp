@@ -0,0 +1,42 @@
+#include "SIMD.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Returns true if both the processor and the operating system support AVX and FMA.
+static bool supportsAVXFMA(){
+
+#if !defined(MATH_AVX_FMA)
+    return false;
+
+#elif defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+
+#else
+    int info[4];
+    __cpuid(info, 1);
+
+    bool osSavesRegisters = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osSavesRegisters || !avx || !fma)
+        return false;
+
+    // The operating system must save the full AVX registers on context switches.
+    return (_xgetbv(0) & 6) == 6;
+#endif
+}
+
+SIMDLevel getSIMDLevel(){
+
+    static const SIMDLevel level =
+#if defined(MATH_SSE2)
+        supportsAVXFMA() ? SIMD_AVX_FMA : SIMD_SSE2;
+#else
+        SIMD_SCALAR;
+#endif
+
+    return level;
+}
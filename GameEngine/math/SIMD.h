@@ -0,0 +1,38 @@
+/*
+    Detects the SIMD instruction sets the math code can use.
+    SSE2 is used whenever the compiler targets it (every x86-64 build).
+    AVX and FMA are only used by functions compiled for them, after
+    checking at runtime that the processor supports them.
+*/
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX and FMA need a per-function target with GCC and Clang. MSVC always accepts them.
+#if defined(MATH_SSE2) && (defined(__GNUC__) || defined(_MSC_VER))
+#define MATH_AVX_FMA
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define MATH_TARGET_AVX_FMA __attribute__((target("avx,fma")))
+#else
+#define MATH_TARGET_AVX_FMA
+#endif
+#endif
+
+// The instruction sets, from the least to the most capable.
+enum SIMDLevel{
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX_FMA
+};
+
+// The most capable instruction set supported by both the build and the processor.
+SIMDLevel getSIMDLevel();
+
+#endif // SIMD_H
@@ -1,8 +1,10 @@
 #include "SquareMatrix.h"
+#include "Matrix4Kernels.h"
 
 template<unsigned size>
-SquareMatrix<size>::SquareMatrix()
-{}
+SquareMatrix<size>::SquareMatrix(){
+    identity();
+}
 
 template<unsigned size>
 void SquareMatrix<size>::identity(){
@@ -11,6 +13,15 @@ void SquareMatrix<size>::identity(){
             elements[row][col] = row == col? 1 : 0;
 }
 
+// Laplace expansion along the first row.
+template<unsigned size>
+float SquareMatrix<size>::determinant() const{
+    float det = 0;
+    for (unsigned col = 0; col < size; col++)
+        det += elements[0][col] * cofactor(0, col);
+    return det;
+}
+
 template<unsigned size>
 SquareMatrix<size> SquareMatrix<size>::inverse() const{
     float det = determinant();
@@ -264,14 +275,130 @@ const float* SquareMatrix<size>::operator[](int index) const{
     return elements[index];
 }
 
-template class SquareMatrix<2>;
-template class SquareMatrix<3>;
-template class SquareMatrix<4>;
+template<>
+float SquareMatrix<1>::determinant() const{
+    return elements[0][0];
+}
+
+template<>
+float SquareMatrix<2>::determinant() const{
+    return elements[0][0] * elements[1][1] - elements[1][0] * elements[0][1];
+}
+
+template<>
+float SquareMatrix<3>::determinant() const{
+    const float (*m)[3] = elements;
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+         - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+         + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+template<>
+float SquareMatrix<4>::determinant() const{
+    const float (*m)[4] = elements;
+
+    // The 2x2 determinants of the top two rows times their complements in the bottom two rows.
+    return (m[0][0] * m[1][1] - m[1][0] * m[0][1]) * (m[2][2] * m[3][3] - m[3][2] * m[2][3])
+         - (m[0][0] * m[1][2] - m[1][0] * m[0][2]) * (m[2][1] * m[3][3] - m[3][1] * m[2][3])
+         + (m[0][0] * m[1][3] - m[1][0] * m[0][3]) * (m[2][1] * m[3][2] - m[3][1] * m[2][2])
+         + (m[0][1] * m[1][2] - m[1][1] * m[0][2]) * (m[2][0] * m[3][3] - m[3][0] * m[2][3])
+         - (m[0][1] * m[1][3] - m[1][1] * m[0][3]) * (m[2][0] * m[3][2] - m[3][0] * m[2][2])
+         + (m[0][2] * m[1][3] - m[1][2] * m[0][3]) * (m[2][0] * m[3][1] - m[3][0] * m[2][1]);
+}
+
+template<>
+SquareMatrix<2> SquareMatrix<2>::inverse() const{
+    float det = determinant();
+
+    // Not invertible
+    if (det == 0)
+        return SquareMatrix();
 
+    float invDet = 1 / det;
 
+    SquareMatrix tmp;
+    tmp.elements[0][0] = elements[1][1] * invDet;
+    tmp.elements[0][1] = -elements[0][1] * invDet;
+    tmp.elements[1][0] = -elements[1][0] * invDet;
+    tmp.elements[1][1] = elements[0][0] * invDet;
+    return tmp;
+}
 
+template<>
+SquareMatrix<3> SquareMatrix<3>::inverse() const{
+    const float (*m)[3] = elements;
 
+    // The cofactors of the first column, reused by the determinant.
+    float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    float c10 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    float c20 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
 
+    float det = m[0][0] * c00 + m[0][1] * c10 + m[0][2] * c20;
 
+    // Not invertible
+    if (det == 0)
+        return SquareMatrix();
 
+    float invDet = 1 / det;
+
+    // The transposed cofactors (the adjugate) over the determinant.
+    SquareMatrix tmp;
+    tmp.elements[0][0] = c00 * invDet;
+    tmp.elements[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+    tmp.elements[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+
+    tmp.elements[1][0] = c10 * invDet;
+    tmp.elements[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+    tmp.elements[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+
+    tmp.elements[2][0] = c20 * invDet;
+    tmp.elements[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+    tmp.elements[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+    return tmp;
+}
 
+template<>
+SquareMatrix<4> SquareMatrix<4>::inverse() const{
+    SquareMatrix tmp;
+
+    // Not invertible
+    if (!getMatrix4Kernels().inverse(getFirstAddr(), &tmp.elements[0][0]))
+        return SquareMatrix();
+
+    return tmp;
+}
+
+template<>
+SquareMatrix<4> SquareMatrix<4>::transpose() const{
+    SquareMatrix tmp;
+    getMatrix4Kernels().transpose(getFirstAddr(), &tmp.elements[0][0]);
+    return tmp;
+}
+
+template<>
+SquareMatrix<4> SquareMatrix<4>::operator*(const SquareMatrix& other) const{
+    SquareMatrix tmp;
+    getMatrix4Kernels().multiply(getFirstAddr(), other.getFirstAddr(), &tmp.elements[0][0]);
+    return tmp;
+}
+
+template<>
+Vector<4> SquareMatrix<4>::operator*(const Vector<4>& v) const{
+    Vector<4> tmp;
+    getMatrix4Kernels().transform(getFirstAddr(), v.components, tmp.components);
+    return tmp;
+}
+
+template<>
+const SquareMatrix<4>& SquareMatrix<4>::operator*=(const SquareMatrix& other){
+
+    // The kernel can not write over its operands.
+    SquareMatrix tmp;
+    getMatrix4Kernels().multiply(getFirstAddr(), other.getFirstAddr(), &tmp.elements[0][0]);
+    *this = tmp;
+    return *this;
+}
+
+template class SquareMatrix<2>;
+template class SquareMatrix<3>;
+template class SquareMatrix<4>;
@@ -35,11 +35,14 @@ friend ostream& operator<<(ostream& os, const SquareMatrix& m){
 }
 
 public:
+    // The identity matrix.
     SquareMatrix();
 
     void identity();
 
-    float determinant() const { return 0; };
+    float determinant() const;
+
+    // A matrix that is not invertible results in the identity matrix.
     SquareMatrix inverse() const;
     SquareMatrix adjugate() const;
     SquareMatrix cofactorMatrix() const;
@@ -90,4 +93,20 @@ public:
 
 };
 
+// The determinants and inverses of the sizes in use are written out in closed form.
+// The 1x1 determinant ends the cofactor expansion of the 2x2 minors.
+template<> float SquareMatrix<1>::determinant() const;
+template<> float SquareMatrix<2>::determinant() const;
+template<> float SquareMatrix<3>::determinant() const;
+template<> float SquareMatrix<4>::determinant() const;
+template<> SquareMatrix<2> SquareMatrix<2>::inverse() const;
+template<> SquareMatrix<3> SquareMatrix<3>::inverse() const;
+
+// 4x4 matrices are specialized to use the SIMD kernels (see Matrix4Kernels.h).
+template<> SquareMatrix<4> SquareMatrix<4>::inverse() const;
+template<> SquareMatrix<4> SquareMatrix<4>::transpose() const;
+template<> SquareMatrix<4> SquareMatrix<4>::operator*(const SquareMatrix<4>&) const;
+template<> Vector<4> SquareMatrix<4>::operator*(const Vector<4>&) const;
+template<> const SquareMatrix<4>& SquareMatrix<4>::operator*=(const SquareMatrix<4>&);
+
 #endif // SQUAREMATRIX_H
@@ -1,20 +1,18 @@
 #include "Vector.h"
+#include "SIMD.h"
 #include <cmath>
 
 template <unsigned size>
-Vector<size>::Vector()
-{}
-
-template <unsigned size>
-Vector<size>::~Vector()
-{}
+Vector<size>::Vector(){
+    zero();
+}
 
 template <unsigned size>
 Vector<size> Vector<size>::add(const Vector& v) const{
 
     Vector u;
     for(unsigned i = 0; i < size; i++)
-        u.components[i] = components[i] + v[i];
+        u.components[i] = this->components[i] + v[i];
 
     return u;
 }
@@ -24,14 +22,14 @@ Vector<size> Vector<size>::sub(const Vector& v) const{
 
     Vector u;
     for(unsigned i = 0; i < size; i++)
-        u.components[i] = components[i] - v[i];
+        u.components[i] = this->components[i] - v[i];
 
     return u;
 }
 
 template <unsigned size>
 void Vector<size>::scale(float scale){
-    for (float& f : components)
+    for (float& f : this->components)
         f *= scale;
 }
 
@@ -39,7 +37,7 @@ template <unsigned size>
 float Vector<size>::dot(const Vector& v) const{
     float sum = 0;
     for(unsigned i = 0; i < size; i++){
-        sum += components[i] * v[i];
+        sum += this->components[i] * v[i];
     }
     return sum;
 }
@@ -58,7 +56,7 @@ Vector<size> Vector<size>::normal() const{
     float mag = magnitude();
 
     for(unsigned i = 0; i < size; i++)
-        norm[i] = components[i] / mag;
+        norm[i] = this->components[i] / mag;
 
     return norm;
 }
@@ -66,19 +64,19 @@ Vector<size> Vector<size>::normal() const{
 template <unsigned size>
 void Vector<size>::normalize(){
     float mag = magnitude();
-    for (float& f : components)
+    for (float& f : this->components)
         f /= mag;
 }
 
 template <unsigned size>
 void Vector<size>::zero(){
-    for(float& f : components)
+    for(float& f : this->components)
         f = 0;
 }
 
 template <unsigned size>
 bool Vector<size>::isZero() const{
-    for (const float f : components)
+    for (const float f : this->components)
         if (f != 0) return false;
     return true;
 }
@@ -91,7 +89,7 @@ void Vector<size>::setMagnitude(float mag){
     if(m != 0){
         float ratio = mag / m;
 
-        for (float& f : components)
+        for (float& f : this->components)
             f *= ratio;
     }
 }
@@ -104,7 +102,7 @@ float Vector<size>::magnitude() const{
 template <unsigned size>
 float Vector<size>::sqMagnitude() const{
     float sum = 0;
-    for(const float f : components)
+    for(const float f : this->components)
         sum += f * f;
     return sum;
 }
@@ -113,7 +111,7 @@ template <unsigned size>
 bool Vector<size>::operator==(const Vector& v) const{
 
     for(unsigned i = 0; i < size; i++)
-        if (components[i] != v[i]) return false;
+        if (this->components[i] != v[i]) return false;
 
     return true;
 }
@@ -123,15 +121,6 @@ bool Vector<size>::operator!=(const Vector& v) const{
     return !(*this==v);
 }
 
-template <unsigned size>
-const Vector<size>& Vector<size>::operator=(const Vector& v){
-    if(this != &v){
-        for(unsigned i = 0; i < size; i++)
-            components[i] = v[i];
-    }
-    return *this;
-}
-
 template <unsigned size>
 Vector<size> Vector<size>::operator+(const Vector& v) const{
     return add(v);
@@ -146,7 +135,7 @@ template <unsigned size>
 Vector<size> Vector<size>::operator*(float scale) const{
     Vector tmp;
     for(unsigned i = 0; i < size; i++)
-        tmp[i] = components[i] * scale;
+        tmp[i] = this->components[i] * scale;
 
     return tmp;
 }
@@ -155,7 +144,7 @@ template <unsigned size>
 const Vector<size>& Vector<size>::operator+=(const Vector& v){
 
     for(unsigned i = 0; i < size; i++)
-        components[i] += v[i];
+        this->components[i] += v[i];
 
     return *this;
 }
@@ -163,7 +152,7 @@ const Vector<size>& Vector<size>::operator+=(const Vector& v){
 template <unsigned size>
 const Vector<size>& Vector<size>::operator-=(const Vector& v){
     for(unsigned i = 0; i < size; i++)
-        components[i] -= v[i];
+        this->components[i] -= v[i];
     return *this;
 }
 
@@ -175,14 +164,71 @@ const Vector<size>& Vector<size>::operator*=(float scale){
 
 template<unsigned size>
 float Vector<size>::operator[](int index) const{
-    return components[index];
+    return this->components[index];
 }
 
 template<unsigned size>
 float& Vector<size>::operator[](int index){
-    return components[index];
+    return this->components[index];
+}
+
+#if defined(MATH_SSE2)
+
+template <>
+Vector<4> Vector<4>::add(const Vector& v) const{
+    Vector u;
+    _mm_storeu_ps(u.components, _mm_add_ps(_mm_loadu_ps(components), _mm_loadu_ps(v.components)));
+    return u;
+}
+
+template <>
+Vector<4> Vector<4>::sub(const Vector& v) const{
+    Vector u;
+    _mm_storeu_ps(u.components, _mm_sub_ps(_mm_loadu_ps(components), _mm_loadu_ps(v.components)));
+    return u;
 }
 
+template <>
+float Vector<4>::dot(const Vector& v) const{
+    __m128 products = _mm_mul_ps(_mm_loadu_ps(components), _mm_loadu_ps(v.components));
+
+    // Add the upper half onto the lower half, then the two remaining lanes.
+    __m128 sums = _mm_add_ps(products, _mm_movehl_ps(products, products));
+    sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1));
+    return _mm_cvtss_f32(sums);
+}
+
+template <>
+Vector<4> Vector<4>::operator*(float scale) const{
+    Vector u;
+    _mm_storeu_ps(u.components, _mm_mul_ps(_mm_loadu_ps(components), _mm_set1_ps(scale)));
+    return u;
+}
+
+#else
+
+template <>
+Vector<4> Vector<4>::add(const Vector& v) const{
+    return Vector(*this) += v;
+}
+
+template <>
+Vector<4> Vector<4>::sub(const Vector& v) const{
+    return Vector(*this) -= v;
+}
+
+template <>
+float Vector<4>::dot(const Vector& v) const{
+    return components[0] * v[0] + components[1] * v[1] + components[2] * v[2] + components[3] * v[3];
+}
+
+template <>
+Vector<4> Vector<4>::operator*(float scale) const{
+    return Vector(*this) *= scale;
+}
+
+#endif // MATH_SSE2
+
 template class Vector<2>;
 template class Vector<3>;
 template class Vector<4>;
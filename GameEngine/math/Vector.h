@@ -5,14 +5,48 @@
 
 using std::ostream;
 
+// The memory of a vector: exactly size floats, with no padding.
+// The small sizes are specialized so their components can also be accessed by
+// name, e.g. v.x is v.components[0].
+template<unsigned size>
+struct VectorStorage{
+    float components[size];
+};
+
+template<>
+struct VectorStorage<2>{
+    union{
+        float components[2];
+        struct{ float x, y; };
+    };
+};
+
+template<>
+struct VectorStorage<3>{
+    union{
+        float components[3];
+        struct{ float x, y, z; };
+    };
+};
+
+template<>
+struct VectorStorage<4>{
+    union{
+        float components[4];
+        struct{ float x, y, z, w; };
+    };
+};
+
 /**
     A general mathematical vector.
 */
 
 // Template is used to be able to create a fixed sized array
 // upon compile time to avoid using the heap.
+// Vectors are plain data: they can be copied with memcpy and their arrays
+// handed to OpenGL as they are.
 template<unsigned size>
-class Vector {
+class Vector : public VectorStorage<size> {
 
 friend ostream& operator<<(ostream& os, const Vector& v){
     os << '<';
@@ -27,8 +61,8 @@ friend ostream& operator<<(ostream& os, const Vector& v){
 }
 
 public:
+    // All components are zero.
     Vector();
-    ~Vector();
 
     Vector add(const Vector&) const;
     Vector sub(const Vector&) const;
@@ -56,7 +90,6 @@ public:
 
     bool operator==(const Vector&) const;
     bool operator!=(const Vector&) const;
-    const Vector& operator=(const Vector&);
 
     Vector operator+(const Vector&) const;
     Vector operator-(const Vector&) const;
@@ -69,8 +102,12 @@ public:
     // Indexing to access vector elements
     float operator[](int index) const;
     float& operator[](int index);
-
-    float components[size];
 };
 
+// 4 component vectors fill a SIMD register, so their arithmetic is specialized.
+template<> Vector<4> Vector<4>::add(const Vector<4>&) const;
+template<> Vector<4> Vector<4>::sub(const Vector<4>&) const;
+template<> float Vector<4>::dot(const Vector<4>&) const;
+template<> Vector<4> Vector<4>::operator*(float scale) const;
+
 #endif // VECTOR_H
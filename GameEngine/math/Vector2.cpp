@@ -1,35 +1,30 @@
 #include "Vector2.h"
 #include <cmath>
 
-Vector2::Vector2() :
-    x(components[0]), y(components[1])
+Vector2::Vector2()
 {
     //ctor
 }
 
-Vector2::Vector2(float x, float y) :
-    x(components[0]), y(components[1])
+Vector2::Vector2(float x, float y)
 {
     this->x = x;
     this->y = y;
 }
 
-Vector2::Vector2(const Vector& v) :
-    x(components[0]), y(components[1])
+Vector2::Vector2(const Vector& v)
 {
     x = v[0];
     y = v[1];
 }
 
-Vector2::Vector2(const Vector<3>& v) :
-    x(components[0]), y(components[1])
+Vector2::Vector2(const Vector<3>& v)
 {
     x = v[0];
     y = v[1];
 }
 
-Vector2::Vector2(const Vector<4>& v) :
-    x(components[0]), y(components[1])
+Vector2::Vector2(const Vector<4>& v)
 {
     x = v[0];
     y = v[1];
@@ -52,14 +47,3 @@ float Vector2::direction() const{
     if(y < 0) r *= -1;
     return r;
 }
-
-Vector2& Vector2::operator=(const Vector2& v){
-    if(this != &v){
-        x = v.x;
-        y = v.y;
-    }
-    return *this;
-}
-
-
-
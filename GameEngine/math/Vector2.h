@@ -1,6 +1,8 @@
 #ifndef VECTOR2_H
 #define VECTOR2_H
 
+#include <type_traits>
+
 #include "Vector.h"
 #include "Vector3.h"
 
@@ -25,15 +27,12 @@ public:
 
     // Uses the angle between i-unit vector and the vector itself.
     float direction() const;
-
-    // To handle the reference value assignments.
-    Vector2& operator=(const Vector2&);
-
-    // References to the individual components of the array.
-    float& x;
-    float& y;
 };
 
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be 2 packed floats");
+static_assert(std::is_standard_layout<Vector2>::value, "Vector2 must be standard layout");
+static_assert(std::is_trivially_copyable<Vector2>::value, "Vector2 must be trivially copyable");
+
 typedef Vector2 Vec2;
 typedef Vector2 vec2;
 
@@ -1,6 +1,8 @@
 #ifndef VECTOR3_H
 #define VECTOR3_H
 
+#include <type_traits>
+
 #include "Vector.h"
 #include "Vector4.h"
 
@@ -13,16 +15,13 @@ public:
     Vector3(const Vector<4>&);
 
     Vector3 cross(const Vector3& vec) const;
-
-    // To handle the reference value assignments.
-    Vector3& operator=(const Vector3&);
-
-    // References to the individual components of the array.
-    float& x;
-    float& y;
-    float& z;
 };
 
+// Arrays of positions and normals are uploaded to OpenGL as tightly packed floats.
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+static_assert(std::is_standard_layout<Vector3>::value, "Vector3 must be standard layout");
+static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 must be trivially copyable");
+
 typedef Vector3 Vec3;
 typedef Vector3 vec3;
 
@@ -1,6 +1,8 @@
 #ifndef VECTOR4_H
 #define VECTOR4_H
 
+#include <type_traits>
+
 #include "Vector.h"
 
 class Vector4 : public Vector<4>
@@ -8,17 +10,13 @@ class Vector4 : public Vector<4>
 public:
     Vector4();
     Vector4(float x, float y, float z, float w);
-
-    // To handle the reference value assignments.
-    Vector4& operator=(const Vector4&);
-
-    // References to the individual components of the array.
-    float& x;
-    float& y;
-    float& z;
-    float& w;
 };
 
+// Also the size of a 16 byte SIMD register.
+static_assert(sizeof(Vector4) == 4 * sizeof(float), "Vector4 must be 4 packed floats");
+static_assert(std::is_standard_layout<Vector4>::value, "Vector4 must be standard layout");
+static_assert(std::is_trivially_copyable<Vector4>::value, "Vector4 must be trivially copyable");
+
 typedef Vector4 Vec4;
 typedef Vector4 vec4;
 
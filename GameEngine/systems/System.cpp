@@ -1,6 +1,6 @@
 #include "System.h"
 
-System::System()
+System::System() : mainThreadOnly(false)
 {
     //ctor
 }
@@ -9,3 +9,32 @@ System::~System()
 {
     //dtor
 }
+
+const char* System::getName() const{
+    return "SYSTEM";
+}
+
+const ComponentSignature& System::getReads() const{
+    return readSignature;
+}
+
+const ComponentSignature& System::getWrites() const{
+    return writeSignature;
+}
+
+bool System::isMainThreadOnly() const{
+    return mainThreadOnly;
+}
+
+bool System::conflictsWith(const System& other) const{
+
+    // Writing a type conflicts with any other access to it.
+    ComponentSignature otherAccess = other.readSignature | other.writeSignature;
+    ComponentSignature access = readSignature | writeSignature;
+
+    return (writeSignature & otherAccess).any() || (other.writeSignature & access).any();
+}
+
+void System::setMainThreadOnly(bool value){
+    mainThreadOnly = value;
+}
@@ -1,16 +1,58 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include "../components/ComponentType.h"
 
+// A system updates the components of entities every frame.
+// Systems declare the component types they read and write so the scheduler
+// can run the ones that do not conflict at the same time.
+// Structural changes (adding/removing components, destroying entities) must be
+// recorded in Engine::getCommandBuffer() instead of applied directly.
 class System
 {
     public:
         System();
         virtual ~System();
 
+        virtual void update(float deltaTime) = 0;
+
+        // Also names the profiler zone of the system, so the string must never be freed.
+        virtual const char* getName() const;
+
+        const ComponentSignature& getReads() const;
+        const ComponentSignature& getWrites() const;
+
+        // Systems that use OpenGL or SDL must run on the main thread.
+        bool isMainThreadOnly() const;
+
+        // Returns true if the two systems cannot run at the same time.
+        bool conflictsWith(const System&) const;
+
     protected:
 
+        // Declare the accessed component types. Meant to be called from the constructor.
+        template<typename... Types>
+        void reads();
+
+        template<typename... Types>
+        void writes();
+
+        void setMainThreadOnly(bool);
+
     private:
+        ComponentSignature readSignature;
+        ComponentSignature writeSignature;
+        bool mainThreadOnly;
 };
 
+template<typename... Types>
+void System::reads(){
+    readSignature |= ComponentType::getSignature<Types...>();
+}
+
+template<typename... Types>
+void System::writes(){
+    writeSignature |= ComponentType::getSignature<Types...>();
+}
+
 #endif // SYSTEM_H
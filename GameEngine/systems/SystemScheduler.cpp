@@ -0,0 +1,128 @@
+#include "SystemScheduler.h"
+#include "../util/Profiler.h"
+
+SystemScheduler::SystemScheduler() :
+    graphDirty(false), jobSystem(nullptr), deltaTime(0), remaining(0)
+{
+    //ctor
+}
+
+SystemScheduler::~SystemScheduler(){
+    for (Node& node : nodes)
+        delete node.system;
+}
+
+void SystemScheduler::addSystem(System* system){
+
+    Node node;
+    node.system = system;
+    node.dependencyCount = 0;
+    nodes.push_back(node);
+
+    graphDirty = true;
+}
+
+unsigned SystemScheduler::getSystemCount() const{
+    return nodes.size();
+}
+
+void SystemScheduler::update(float deltaTime, JobSystem& jobSystem){
+
+    if (nodes.empty())
+        return;
+
+    if (graphDirty)
+        buildGraph();
+
+    this->jobSystem = &jobSystem;
+    this->deltaTime = deltaTime;
+    remaining = nodes.size();
+
+    for (unsigned i = 0; i < nodes.size(); i++)
+        pendingDependencies[i] = nodes[i].dependencyCount;
+
+    // Start from the systems that depend on nothing.
+    for (unsigned i = 0; i < nodes.size(); i++)
+        if (nodes[i].dependencyCount == 0)
+            schedule(i);
+
+    // Run main thread systems as they become ready until every system is done.
+    std::unique_lock<std::mutex> lock(mutex);
+    while (remaining > 0){
+
+        if (!mainThreadQueue.empty()){
+            unsigned node = mainThreadQueue.back();
+            mainThreadQueue.pop_back();
+
+            lock.unlock();
+            execute(node);
+            lock.lock();
+            continue;
+        }
+
+        // Run a queued system in the meantime. Sleep only if there is none,
+        // the workers then run whatever gets queued.
+        lock.unlock();
+        bool ranJob = jobSystem.runPendingJob();
+        lock.lock();
+
+        if (!ranJob && remaining > 0 && mainThreadQueue.empty())
+            stateChanged.wait(lock);
+    }
+}
+
+void SystemScheduler::buildGraph(){
+
+    for (Node& node : nodes){
+        node.dependents.clear();
+        node.dependencyCount = 0;
+    }
+
+    for (unsigned i = 0; i < nodes.size(); i++){
+        for (unsigned j = i + 1; j < nodes.size(); j++){
+            if (nodes[i].system->conflictsWith(*nodes[j].system)){
+                nodes[i].dependents.push_back(j);
+                nodes[j].dependencyCount++;
+            }
+        }
+    }
+
+    // Atomics can not be moved, so the vector is swapped instead of resized.
+    vector<std::atomic<unsigned>> counters(nodes.size());
+    pendingDependencies.swap(counters);
+
+    graphDirty = false;
+}
+
+void SystemScheduler::schedule(unsigned node){
+
+    if (nodes[node].system->isMainThreadOnly()){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            mainThreadQueue.push_back(node);
+        }
+        stateChanged.notify_one();
+        return;
+    }
+
+    jobSystem->run([this, node]{ execute(node); });
+}
+
+void SystemScheduler::execute(unsigned node){
+
+    {
+        PROFILE_ZONE(nodes[node].system->getName());
+        nodes[node].system->update(deltaTime);
+    }
+
+    // The last finished dependency releases the dependent system.
+    for (unsigned dependent : nodes[node].dependents)
+        if (--pendingDependencies[dependent] == 0)
+            schedule(dependent);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining--;
+    }
+    stateChanged.notify_one();
+}
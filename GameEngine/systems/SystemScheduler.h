@@ -0,0 +1,70 @@
+#ifndef SYSTEMSCHEDULER_H
+#define SYSTEMSCHEDULER_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "System.h"
+#include "../core/JobSystem.h"
+
+using std::vector;
+
+// Runs the registered systems every frame.
+// A system depends on every system registered before it that it conflicts with
+// (see System::conflictsWith), which keeps the registration order for systems
+// touching the same components. Systems with no path between them in the
+// resulting graph run in parallel as jobs of the job system.
+class SystemScheduler
+{
+public:
+    SystemScheduler();
+    ~SystemScheduler();
+
+    // The scheduler takes ownership of the system.
+    void addSystem(System* system);
+
+    // Runs every system once and returns when all of them are done.
+    // The calling thread runs the main thread only systems, and helps with
+    // the other ones while it waits.
+    void update(float deltaTime, JobSystem& jobSystem);
+
+    unsigned getSystemCount() const;
+
+private:
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    struct Node{
+        System* system;
+
+        // The systems that must wait for this one.
+        vector<unsigned> dependents;
+        unsigned dependencyCount;
+    };
+
+    void buildGraph();
+
+    // Queue the system to run now that its dependencies are done.
+    void schedule(unsigned node);
+
+    // Runs the system and releases the systems waiting for it.
+    void execute(unsigned node);
+
+    vector<Node> nodes;
+    bool graphDirty;
+
+    // Per frame state.
+    JobSystem* jobSystem;
+    float deltaTime;
+    vector<std::atomic<unsigned>> pendingDependencies;
+
+    // Guards the main thread queue and the count of unfinished systems.
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+    vector<unsigned> mainThreadQueue;
+    unsigned remaining;
+};
+
+#endif // SYSTEMSCHEDULER_H
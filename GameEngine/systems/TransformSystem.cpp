@@ -0,0 +1,157 @@
+#include <iostream>
+
+#include "TransformSystem.h"
+#include "../core/Engine.h"
+
+using std::cerr;
+
+// Levels smaller than this are not worth splitting into jobs.
+static const unsigned PARALLEL_LEVEL_SIZE = 2048;
+static const unsigned PARALLEL_GRAIN_SIZE = 512;
+
+static const unsigned NO_PARENT = BaseComponentPool::INVALID_INDEX;
+
+TransformSystem::TransformSystem(ComponentManager& componentManager) :
+    componentManager(componentManager), poolVersion(0), hierarchyVersion(0), built(false)
+{
+    writes<Transform>();
+}
+
+void TransformSystem::update(float /*deltaTime*/){
+
+    ComponentPool<Transform>& pool = componentManager.getPool<Transform>();
+
+    // Every world matrix must be recomputed once the hierarchy changes.
+    bool rebuilt = false;
+    if (!built || pool.getVersion() != poolVersion || Transform::getHierarchyVersion() != hierarchyVersion){
+        rebuildHierarchy(pool);
+        rebuilt = true;
+    }
+
+    JobSystem* jobSystem = Engine::getJobSystem();
+
+    for (unsigned level = 0; level + 1 < levelStarts.size(); level++){
+        unsigned first = levelStarts[level];
+        unsigned last = levelStarts[level + 1];
+
+        if (jobSystem && last - first >= PARALLEL_LEVEL_SIZE){
+            jobSystem->parallelFor(first, last, PARALLEL_GRAIN_SIZE, [this, &pool, rebuilt](unsigned begin, unsigned end){
+                updateRange(pool, begin, end, rebuilt);
+            });
+        }
+        else
+            updateRange(pool, first, last, rebuilt);
+    }
+}
+
+void TransformSystem::updateRange(ComponentPool<Transform>& pool, unsigned first, unsigned last, bool updateAll){
+
+    for (unsigned i = first; i < last; i++){
+        Transform& transform = pool[order[i]];
+        unsigned parent = parents[i];
+
+        // The parent was visited in the previous level.
+        bool changed = updateAll || transform.hasLocalChanged() || (parent != NO_PARENT && dirty[parent]);
+
+        dirty[i] = changed;
+        transform.worldChanged = changed;
+
+        if (!changed)
+            continue;
+
+        if (parent == NO_PARENT)
+            transform.world = transform.localMatrix();
+        else
+            transform.world = pool[order[parent]].world * transform.localMatrix();
+
+        transform.update();
+    }
+}
+
+void TransformSystem::rebuildHierarchy(ComponentPool<Transform>& pool){
+
+    static const unsigned UNKNOWN = 0xFFFFFFFF;
+    static const unsigned VISITING = 0xFFFFFFFE;
+
+    unsigned count = pool.size();
+
+    // The pool slot of each transform's parent.
+    vector<unsigned> parentSlots(count);
+    for (unsigned slot = 0; slot < count; slot++){
+        unsigned parentId = pool[slot].getParentId();
+        parentSlots[slot] = parentId == INVALID_ENTITY ? NO_PARENT : pool.indexOf(parentId);
+    }
+
+    // Walk up from each transform until a known depth is found, then assign the
+    // depths back down the chain. Every transform is walked through only once.
+    vector<unsigned> depths(count, UNKNOWN);
+    vector<unsigned> chain;
+    unsigned maxDepth = 0;
+
+    for (unsigned start = 0; start < count; start++){
+        unsigned slot = start;
+        while (slot != NO_PARENT && depths[slot] == UNKNOWN){
+            depths[slot] = VISITING;
+            chain.push_back(slot);
+            slot = parentSlots[slot];
+        }
+
+        // Went around a loop of parents. Break it at the last transform visited.
+        if (slot != NO_PARENT && depths[slot] == VISITING){
+            cerr << "Error. The transform of entity " << pool[chain.back()].getEntityId()
+                 << " is its own ancestor. It is moved to the root.\n";
+
+            pool[chain.back()].parentId = INVALID_ENTITY;
+            parentSlots[chain.back()] = NO_PARENT;
+            slot = NO_PARENT;
+        }
+
+        unsigned depth = slot == NO_PARENT ? 0 : depths[slot] + 1;
+        while (!chain.empty()){
+            depths[chain.back()] = depth;
+            chain.pop_back();
+
+            if (depth > maxDepth)
+                maxDepth = depth;
+            depth++;
+        }
+    }
+
+    // Counting sort of the slots by depth.
+    levelStarts.assign(maxDepth + 2, 0);
+    for (unsigned slot = 0; slot < count; slot++)
+        levelStarts[depths[slot] + 1]++;
+
+    for (unsigned level = 1; level < levelStarts.size(); level++)
+        levelStarts[level] += levelStarts[level - 1];
+
+    vector<unsigned> next(levelStarts.begin(), levelStarts.end() - 1);
+    vector<unsigned> sortedIndices(count);
+    order.resize(count);
+
+    for (unsigned slot = 0; slot < count; slot++){
+        unsigned index = next[depths[slot]]++;
+        order[index] = slot;
+        sortedIndices[slot] = index;
+    }
+
+    parents.resize(count);
+    for (unsigned i = 0; i < count; i++){
+        unsigned parentSlot = parentSlots[order[i]];
+        parents[i] = parentSlot == NO_PARENT ? NO_PARENT : sortedIndices[parentSlot];
+    }
+
+    dirty.assign(count, 0);
+
+    poolVersion = pool.getVersion();
+    hierarchyVersion = Transform::getHierarchyVersion();
+    built = true;
+}
+
+unsigned TransformSystem::getDepth() const{
+    return levelStarts.size() > 1 ? levelStarts.size() - 1 : 1;
+}
+
+const char* TransformSystem::getName() const{
+    return "Transforms";
+}
@@ -0,0 +1,57 @@
+#ifndef TRANSFORMSYSTEM_H
+#define TRANSFORMSYSTEM_H
+
+#include <vector>
+
+#include "System.h"
+#include "../components/ComponentManager.h"
+#include "../components/Transform.h"
+
+using std::vector;
+
+// Computes the world matrix of every transform once per frame.
+// The transforms are sorted by their depth in the hierarchy, so that a single
+// top-down pass over the sorted array visits every parent before its children.
+// Only the transforms whose local transform or parent changed are recomputed.
+// Each depth level is split over the job system, since transforms of the same
+// level never depend on each other.
+class TransformSystem : public System
+{
+public:
+    TransformSystem(ComponentManager& componentManager);
+
+    void update(float deltaTime);
+    const char* getName() const;
+
+    // The number of levels of the hierarchy, 1 if no transform has a parent.
+    unsigned getDepth() const;
+
+private:
+
+    // Sorts the pool slots by depth. Only done when transforms are added or
+    // removed, or a parent changes.
+    void rebuildHierarchy(ComponentPool<Transform>& pool);
+
+    // Updates the sorted nodes [first, last), which must all be in the same level.
+    void updateRange(ComponentPool<Transform>& pool, unsigned first, unsigned last, bool updateAll);
+
+    ComponentManager& componentManager;
+
+    // The pool slots sorted by depth, and the index in 'order' of their parents.
+    vector<unsigned> order;
+    vector<unsigned> parents;
+
+    // Where each depth level starts in 'order', plus the end of the last one.
+    vector<unsigned> levelStarts;
+
+    // Whether the world matrix of the sorted node was recomputed this frame.
+    // Not vector<bool>, since nodes of a level are written from many threads.
+    vector<unsigned char> dirty;
+
+    // The state the hierarchy was built for.
+    unsigned poolVersion;
+    unsigned hierarchyVersion;
+    bool built;
+};
+
+#endif // TRANSFORMSYSTEM_H
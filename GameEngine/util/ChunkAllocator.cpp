@@ -0,0 +1,106 @@
+#include "ChunkAllocator.h"
+
+#include <cstdint>
+#include <algorithm>
+
+AllocatorStats::AllocatorStats() :
+    bytesLive(0), bytesReserved(0), chunksInUse(0), chunksFree(0)
+{}
+
+float AllocatorStats::fragmentation() const{
+    if (bytesReserved == 0)
+        return 0;
+    return 1 - static_cast<float>(bytesLive) / bytesReserved;
+}
+
+const AllocatorStats& AllocatorStats::operator+=(const AllocatorStats& other){
+    bytesLive += other.bytesLive;
+    bytesReserved += other.bytesReserved;
+    chunksInUse += other.chunksInUse;
+    chunksFree += other.chunksFree;
+    return *this;
+}
+
+ChunkAllocator::ChunkAllocator(unsigned chunkSize, unsigned alignment) :
+    chunkSize(std::max<unsigned>(chunkSize, sizeof(void*))),
+    alignment(std::max<unsigned>(alignment, alignof(void*))),
+    freeList(nullptr), freeCount(0)
+{}
+
+ChunkAllocator::~ChunkAllocator(){
+    for (char* block : blocks)
+        delete[] block;
+}
+
+void* ChunkAllocator::allocate(){
+
+    // Reuse a free chunk
+    if (freeList){
+        void* chunk = freeList;
+        freeList = *static_cast<void**>(chunk);
+        freeCount--;
+        return chunk;
+    }
+
+    // Over allocate so the chunk can start on an aligned address.
+    char* block = new char[chunkSize + alignment - 1];
+    blocks.push_back(block);
+
+    return alignChunk(block);
+}
+
+void ChunkAllocator::deallocate(void* chunk){
+    *static_cast<void**>(chunk) = freeList;
+    freeList = chunk;
+    freeCount++;
+}
+
+void ChunkAllocator::releaseFreeChunks(){
+
+    if (!freeList)
+        return;
+
+    vector<void*> freeChunks;
+    freeChunks.reserve(freeCount);
+    for (void* chunk = freeList; chunk; chunk = *static_cast<void**>(chunk))
+        freeChunks.push_back(chunk);
+
+    std::sort(freeChunks.begin(), freeChunks.end());
+
+    // Keep only the blocks whose chunk is still in use.
+    unsigned kept = 0;
+    for (unsigned i = 0; i < blocks.size(); i++){
+        void* chunk = alignChunk(blocks[i]);
+
+        if (std::binary_search(freeChunks.begin(), freeChunks.end(), chunk))
+            delete[] blocks[i];
+        else
+            blocks[kept++] = blocks[i];
+    }
+
+    blocks.resize(kept);
+    freeList = nullptr;
+    freeCount = 0;
+}
+
+unsigned ChunkAllocator::getChunkSize() const{
+    return chunkSize;
+}
+
+unsigned ChunkAllocator::getAlignment() const{
+    return alignment;
+}
+
+void* ChunkAllocator::alignChunk(char* block) const{
+    uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    uintptr_t aligned = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    return reinterpret_cast<void*>(aligned);
+}
+
+AllocatorStats ChunkAllocator::getStats() const{
+    AllocatorStats stats;
+    stats.chunksInUse = blocks.size() - freeCount;
+    stats.chunksFree = freeCount;
+    stats.bytesReserved = blocks.size() * chunkSize;
+    return stats;
+}
@@ -0,0 +1,72 @@
+#ifndef CHUNKALLOCATOR_H
+#define CHUNKALLOCATOR_H
+
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+// The size of a cache line on the targeted CPUs.
+constexpr unsigned CACHE_LINE_SIZE = 64;
+
+// Memory usage of an allocator, in a form that can be reported to telemetry.
+struct AllocatorStats{
+
+    AllocatorStats();
+
+    // Bytes taken by live objects.
+    size_t bytesLive;
+
+    // Bytes of all the chunks owned by the allocator, in use or free.
+    size_t bytesReserved;
+
+    unsigned chunksInUse;
+    unsigned chunksFree;
+
+    // The share of reserved memory that holds no live object, from 0 to 1.
+    float fragmentation() const;
+
+    const AllocatorStats& operator+=(const AllocatorStats&);
+};
+
+// Hands out fixed-size, aligned chunks of memory.
+// Released chunks are kept in an intrusive free list and handed out again
+// before any new memory is requested from the system.
+class ChunkAllocator
+{
+public:
+    // The alignment must be a power of two.
+    ChunkAllocator(unsigned chunkSize, unsigned alignment = CACHE_LINE_SIZE);
+    ~ChunkAllocator();
+
+    void* allocate();
+    void deallocate(void* chunk);
+
+    // Gives the memory of all the free chunks back to the system.
+    void releaseFreeChunks();
+
+    unsigned getChunkSize() const;
+    unsigned getAlignment() const;
+
+    // Fills in the chunk counts. The live bytes are only known by the owner.
+    AllocatorStats getStats() const;
+
+private:
+    ChunkAllocator(const ChunkAllocator&) = delete;
+    ChunkAllocator& operator=(const ChunkAllocator&) = delete;
+
+    // Returns the first aligned address inside the system allocation.
+    void* alignChunk(char* block) const;
+
+    unsigned chunkSize;
+    unsigned alignment;
+
+    // The system allocations, kept to free them since chunks are offset for alignment.
+    vector<char*> blocks;
+
+    // The first free chunk. Every free chunk stores the address of the next one.
+    void* freeList;
+    unsigned freeCount;
+};
+
+#endif // CHUNKALLOCATOR_H
@@ -0,0 +1,249 @@
+#include "CookedMesh.h"
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+
+static const char COOKED_MESH_MAGIC[4] = { 'C', 'M', 'S', 'H' };
+
+// Blocks start on a 16 byte boundary.
+static const uint64_t COOKED_BLOCK_ALIGNMENT = 16;
+
+static uint64_t alignOffset(uint64_t offset){
+    return (offset + COOKED_BLOCK_ALIGNMENT - 1) & ~(COOKED_BLOCK_ALIGNMENT - 1);
+}
+
+static inline uint64_t rotateLeft(uint64_t value, unsigned bits){
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Spreads every bit of the word over the whole word.
+static inline uint64_t mixWord(uint64_t word){
+    word *= 0x87C37B91114253D5ull;
+    word = rotateLeft(word, 31);
+    return word * 0x4CF5AD432745937Full;
+}
+
+uint64_t hashData(const void* data, size_t size){
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t words = size / sizeof(uint64_t);
+
+    for (size_t i = 0; i < words; i++){
+        uint64_t word;
+        memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+
+        hash ^= mixWord(word);
+        hash = rotateLeft(hash, 27) * 5 + 0x52DCE729;
+    }
+
+    // The last 1 to 7 bytes, as one zero padded word.
+    size_t tail = size - words * sizeof(uint64_t);
+    if (tail > 0){
+        uint64_t word = 0;
+        memcpy(&word, bytes + words * sizeof(uint64_t), tail);
+        hash ^= mixWord(word);
+    }
+
+    // The size tells apart data that only differs by trailing zeros.
+    // The final avalanche makes every input bit affect every output bit.
+    hash ^= size;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+const uint32_t CookedMesh::VERSION;
+
+CookedMesh::CookedMesh() : header(nullptr)
+{
+    //ctor
+}
+
+bool CookedMesh::cook(const IndexedModel& model, uint64_t sourceHash, const std::string& path,
+                      const VertexLayout& layout, const vector<MeshLOD>& lods){
+    PROFILE_ZONE("Mesh cook");
+
+    unsigned vertexCount = model.positions.size();
+    unsigned indexCount = model.indices.size();
+
+    CookedMeshHeader fileHeader;
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, COOKED_MESH_MAGIC, sizeof(COOKED_MESH_MAGIC));
+    fileHeader.version = VERSION;
+    fileHeader.vertexCount = vertexCount;
+    fileHeader.indexCount = indexCount;
+    fileHeader.layout = layout;
+    fileHeader.indexSize = ::getIndexSize(vertexCount);
+    fileHeader.vertexOffset = alignOffset(sizeof(CookedMeshHeader));
+    fileHeader.indexOffset = alignOffset(fileHeader.vertexOffset + uint64_t(vertexCount) * layout.getStride());
+    fileHeader.sourceHash = sourceHash;
+
+    if (lods.size() > MeshSimplifier::MAX_LODS){
+        cerr << "Error. Too many levels of detail to cook: " << lods.size() << endl;
+        return false;
+    }
+
+    fileHeader.lodCount = lods.empty() ? 1 : lods.size();
+    fileHeader.lodIndexCount[0] = indexCount;
+
+    for (unsigned i = 0; i < lods.size(); i++){
+        if (uint64_t(lods[i].firstIndex) + lods[i].indexCount > indexCount){
+            cerr << "Error. Level of detail " << i << " is out of the index range" << endl;
+            return false;
+        }
+
+        fileHeader.lodFirstIndex[i] = lods[i].firstIndex;
+        fileHeader.lodIndexCount[i] = lods[i].indexCount;
+        fileHeader.lodError[i] = lods[i].error;
+    }
+
+    // Everything after the header is built in memory, so the checksum can be
+    // computed before the header is written.
+    uint64_t fileSize = fileHeader.indexOffset + uint64_t(indexCount) * fileHeader.indexSize;
+    std::vector<char> body(fileSize - sizeof(CookedMeshHeader), 0);
+
+    if (vertexCount > 0)
+        layout.writeModel(&body[0] + fileHeader.vertexOffset - sizeof(CookedMeshHeader), model);
+
+    if (indexCount > 0)
+        writeIndices(&body[0] + fileHeader.indexOffset - sizeof(CookedMeshHeader), &model.indices[0], indexCount, fileHeader.indexSize);
+
+    AABB bounds;
+    for (const Vector3& position : model.positions)
+        bounds.expand(position);
+
+    // Keep an empty mesh's bounds at the origin instead of the empty box.
+    if (bounds.isEmpty())
+        bounds = AABB(Vector3(), Vector3());
+
+    for (unsigned axis = 0; axis < 3; axis++){
+        fileHeader.boundsMin[axis] = bounds.min[axis];
+        fileHeader.boundsMax[axis] = bounds.max[axis];
+    }
+
+    fileHeader.checksum = hashData(body.empty() ? nullptr : &body[0], body.size());
+
+    std::string temporaryPath = path + ".tmp";
+    FILE* output = fopen(temporaryPath.c_str(), "wb");
+    if (!output){
+        cerr << "Error. Unable to write cooked mesh: " << temporaryPath << endl;
+        return false;
+    }
+
+    bool written = fwrite(&fileHeader, sizeof(fileHeader), 1, output) == 1;
+    if (!body.empty())
+        written = written && fwrite(&body[0], body.size(), 1, output) == 1;
+    written = fclose(output) == 0 && written;
+
+    // rename() does not replace an existing file on every platform.
+    remove(path.c_str());
+
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0){
+        cerr << "Error. Unable to write cooked mesh: " << path << endl;
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool CookedMesh::load(const std::string& path){
+    PROFILE_ZONE("Mesh load");
+    close();
+
+    if (!file.open(path))
+        return false;
+
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    const CookedMeshHeader* fileHeader = reinterpret_cast<const CookedMeshHeader*>(data);
+
+    bool valid = size >= sizeof(CookedMeshHeader)
+        && memcmp(fileHeader->magic, COOKED_MESH_MAGIC, sizeof(COOKED_MESH_MAGIC)) == 0
+        && fileHeader->version == VERSION
+        && fileHeader->layout == VertexLayout::create(fileHeader->layout.getFormat(VERTEX_POSITION),
+                                                      fileHeader->layout.getFormat(VERTEX_UV),
+                                                      fileHeader->layout.getFormat(VERTEX_NORMAL))
+        && (fileHeader->indexSize == sizeof(uint16_t) || fileHeader->indexSize == sizeof(uint32_t))
+        && fileHeader->vertexOffset + uint64_t(fileHeader->vertexCount) * fileHeader->layout.getStride() <= size
+        && fileHeader->indexOffset + uint64_t(fileHeader->indexCount) * fileHeader->indexSize <= size
+        && fileHeader->vertexOffset % COOKED_BLOCK_ALIGNMENT == 0
+        && fileHeader->indexOffset % COOKED_BLOCK_ALIGNMENT == 0
+        && fileHeader->lodCount >= 1 && fileHeader->lodCount <= MeshSimplifier::MAX_LODS
+        && hashData(data + sizeof(CookedMeshHeader), size - sizeof(CookedMeshHeader)) == fileHeader->checksum;
+
+    for (unsigned i = 0; valid && i < fileHeader->lodCount; i++)
+        valid = uint64_t(fileHeader->lodFirstIndex[i]) + fileHeader->lodIndexCount[i] <= fileHeader->indexCount;
+
+    if (!valid){
+        cerr << "Warning. Ignoring an outdated or corrupt cooked mesh: " << path << endl;
+        file.close();
+        return false;
+    }
+
+    header = fileHeader;
+    return true;
+}
+
+void CookedMesh::close(){
+    file.close();
+    header = nullptr;
+}
+
+bool CookedMesh::isLoaded() const{
+    return header != nullptr;
+}
+
+const CookedMeshHeader& CookedMesh::getHeader() const{
+    return *header;
+}
+
+const VertexLayout& CookedMesh::getLayout() const{
+    return header->layout;
+}
+
+const void* CookedMesh::getVertices() const{
+    return file.getData() + header->vertexOffset;
+}
+
+const void* CookedMesh::getIndices() const{
+    return file.getData() + header->indexOffset;
+}
+
+unsigned CookedMesh::getVertexCount() const{
+    return header->vertexCount;
+}
+
+unsigned CookedMesh::getIndexCount() const{
+    return header->indexCount;
+}
+
+unsigned CookedMesh::getIndexSize() const{
+    return header->indexSize;
+}
+
+unsigned CookedMesh::getLODCount() const{
+    return header->lodCount;
+}
+
+MeshLOD CookedMesh::getLOD(unsigned level) const{
+    MeshLOD lod = { header->lodFirstIndex[level], header->lodIndexCount[level], header->lodError[level] };
+    return lod;
+}
+
+AABB CookedMesh::getBounds() const{
+    return AABB(Vector3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]),
+                Vector3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]));
+}
@@ -0,0 +1,110 @@
+/*
+    A mesh converted ("cooked") into a binary file that can be used without parsing.
+    The file is an header followed by an interleaved vertex block and an index block:
+
+        CookedMeshHeader
+        vertexCount * layout.stride bytes     at header.vertexOffset
+        indexCount * indexSize bytes          at header.indexOffset
+
+    The vertex layout (see VertexLayout) and the index size are chosen when cooking.
+    The index block holds every level of detail of the mesh one after the other,
+    the full mesh first (see MeshSimplifier). They all use the same vertices.
+
+    The loader memory maps the file and hands out pointers into the mapping, so
+    the vertices and indices go straight to the GPU without being copied.
+    Values are stored in the byte order of the machine that cooked the file
+    (little endian on every supported platform).
+*/
+
+#ifndef COOKEDMESH_H
+#define COOKEDMESH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "MappedFile.h"
+#include "OBJModel.h"
+#include "VertexLayout.h"
+#include "MeshSimplifier.h"
+#include "../math/AABB.h"
+
+struct CookedMeshHeader
+{
+    char magic[4];
+    uint32_t version;
+
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    VertexLayout layout;
+
+    // 2 or 4 bytes, see getIndexSize().
+    uint32_t indexSize;
+
+    // Byte offsets from the start of the file.
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+
+    float boundsMin[3];
+    float boundsMax[3];
+
+    // The index range and error of each level of detail, the full mesh first.
+    uint32_t lodCount;
+    uint32_t lodFirstIndex[MeshSimplifier::MAX_LODS];
+    uint32_t lodIndexCount[MeshSimplifier::MAX_LODS];
+    float lodError[MeshSimplifier::MAX_LODS];
+
+    // The hash of the source file the mesh was cooked from.
+    uint64_t sourceHash;
+
+    // The hash of every byte after the header.
+    uint64_t checksum;
+};
+
+class CookedMesh
+{
+    public:
+        CookedMesh();
+
+        // Bump whenever the layout of the file, or the way meshes are cooked, changes.
+        // Older files are then cooked again.
+        static const uint32_t VERSION = 7;
+
+        // Writes the model to a cooked mesh file, with its vertices packed in the layout.
+        // The file is written under a temporary name and then renamed, so readers
+        // never see half a file.
+        // The levels of detail index into the model's indices. Without any, the whole
+        // index list is the only level.
+        static bool cook(const IndexedModel& model, uint64_t sourceHash, const std::string& path,
+                         const VertexLayout& layout = VertexLayout::compact(),
+                         const vector<MeshLOD>& lods = vector<MeshLOD>());
+
+        // Maps the file and validates its header, size and checksum.
+        // Returns false if the file is missing, from another version, or corrupt.
+        bool load(const std::string& path);
+        void close();
+
+        bool isLoaded() const;
+
+        const CookedMeshHeader& getHeader() const;
+        const VertexLayout& getLayout() const;
+        const void* getVertices() const;
+        const void* getIndices() const;
+        unsigned getVertexCount() const;
+        unsigned getIndexCount() const;
+        unsigned getIndexSize() const;
+        unsigned getLODCount() const;
+        MeshLOD getLOD(unsigned level) const;
+        AABB getBounds() const;
+
+    private:
+        MappedFile file;
+        const CookedMeshHeader* header;
+};
+
+// A 64 bit hash that consumes 8 bytes per step, with every word mixed before it is
+// combined (as in MurmurHash3), so a change to any byte changes the whole hash.
+// Used for the content hashes of the mesh cache and the checksum of cooked files.
+uint64_t hashData(const void* data, size_t size);
+
+#endif // COOKEDMESH_H
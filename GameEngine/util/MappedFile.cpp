@@ -0,0 +1,153 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using std::cerr;
+using std::endl;
+
+MappedFile::MappedFile() :
+    data(nullptr), size(0), opened(false), fileHandle(nullptr), mappingHandle(nullptr)
+{
+    //ctor
+}
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& path){
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE){
+        cerr << "Error. Unable to open file: " << path << endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)){
+        cerr << "Error. Unable to read the size of file: " << path << endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty files can not be mapped.
+    if (fileSize.QuadPart == 0){
+        CloseHandle(file);
+        opened = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    if (!view){
+        cerr << "Error. Unable to map file: " << path << endl;
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    data = static_cast<const char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    fileHandle = file;
+    mappingHandle = mapping;
+    opened = true;
+    return true;
+}
+
+void MappedFile::close(){
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+
+    data = nullptr;
+    size = 0;
+    opened = false;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path){
+    close();
+
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0){
+        cerr << "Error. Unable to open file: " << path << endl;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0){
+        cerr << "Error. Unable to read the size of file: " << path << endl;
+        ::close(file);
+        return false;
+    }
+
+    // Empty files can not be mapped.
+    if (status.st_size == 0){
+        ::close(file);
+        opened = true;
+        return true;
+    }
+
+    void* view = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping stays valid without the descriptor.
+    ::close(file);
+
+    if (view == MAP_FAILED){
+        cerr << "Error. Unable to map file: " << path << endl;
+        return false;
+    }
+
+    // The file is read front to back, so ask for aggressive read ahead.
+    madvise(view, status.st_size, MADV_SEQUENTIAL);
+
+    data = static_cast<const char*>(view);
+    size = static_cast<size_t>(status.st_size);
+    opened = true;
+    return true;
+}
+
+void MappedFile::close(){
+    if (data)
+        munmap(const_cast<char*>(data), size);
+
+    data = nullptr;
+    size = 0;
+    opened = false;
+}
+
+#endif // _WIN32
+
+bool MappedFile::isOpen() const{
+    return opened;
+}
+
+const char* MappedFile::getData() const{
+    return data;
+}
+
+size_t MappedFile::getSize() const{
+    return size;
+}
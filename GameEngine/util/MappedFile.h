@@ -0,0 +1,39 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// A read only view of a whole file mapped into memory.
+// Pages are loaded by the OS when they are first touched, so nothing is
+// copied up front and several threads can read different parts at once.
+class MappedFile
+{
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        // Returns false and prints the reason if the file can not be mapped.
+        // An empty file opens successfully with a null data pointer.
+        bool open(const std::string& path);
+        void close();
+
+        bool isOpen() const;
+
+        const char* getData() const;
+        size_t getSize() const;
+
+    private:
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data;
+        size_t size;
+        bool opened;
+
+        // The OS handles kept while mapped. Unused on POSIX after mapping.
+        void* fileHandle;
+        void* mappingHandle;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,117 @@
+#include "MeshCache.h"
+#include "MappedFile.h"
+#include "OBJModel.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Profiler.h"
+
+#include <cstdio>
+#include <iostream>
+
+#if defined(_WIN32)
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+using std::cerr;
+using std::endl;
+
+std::string MeshCache::directory = "cache/meshes";
+VertexLayout MeshCache::vertexLayout = VertexLayout::compact();
+
+static const float DEFAULT_LOD_RATIOS[] = { 0.5f, 0.25f, 0.1f };
+vector<float> MeshCache::lodRatios(DEFAULT_LOD_RATIOS, DEFAULT_LOD_RATIOS + 3);
+
+// Creates every missing directory of the path. Existing ones are fine.
+static void createDirectories(const std::string& path){
+    for (size_t i = 1; i <= path.size(); i++){
+        if (i < path.size() && path[i] != '/' && path[i] != '\\')
+            continue;
+
+        std::string parent = path.substr(0, i);
+#if defined(_WIN32)
+        _mkdir(parent.c_str());
+#else
+        mkdir(parent.c_str(), 0755);
+#endif
+    }
+}
+
+static bool fileExists(const std::string& path){
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    fclose(file);
+    return true;
+}
+
+bool MeshCache::load(const std::string& objPath, CookedMesh& mesh, JobSystem* jobSystem){
+    PROFILE_ZONE("Mesh cache");
+
+    uint64_t sourceHash;
+    {
+        MappedFile source;
+        if (!source.open(objPath)){
+            cerr << "Unable to load mesh: " << objPath << endl;
+            return false;
+        }
+        sourceHash = hashData(source.getData(), source.getSize());
+    }
+
+    // The same file cooked with other settings is kept as a separate file.
+    uint64_t key = sourceHash ^ (hashData(&vertexLayout, sizeof(vertexLayout)) * 31);
+    if (!lodRatios.empty())
+        key ^= hashData(&lodRatios[0], lodRatios.size() * sizeof(float)) * 127;
+    std::string cookedPath = getCookedPath(key);
+
+    // Cache hit. An outdated or corrupt file fails to load and is cooked again.
+    if (fileExists(cookedPath) && mesh.load(cookedPath))
+        return true;
+
+    IndexedModel model = OBJModel(objPath, jobSystem).ToIndexedModel(jobSystem);
+
+    // Done once per cooked file, so it may take its time.
+    VertexCacheStats before, after;
+    MeshOptimizer::optimize(model, &before, &after);
+    std::cout << "Optimized " << objPath << ": " << before << " -> " << after << endl;
+
+    vector<MeshLOD> lods = MeshSimplifier::buildLODChain(model, lodRatios);
+
+    createDirectories(directory);
+    if (!CookedMesh::cook(model, sourceHash, cookedPath, vertexLayout, lods))
+        return false;
+
+    return mesh.load(cookedPath);
+}
+
+std::string MeshCache::getCookedPath(uint64_t key){
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+void MeshCache::setDirectory(const std::string& path){
+    directory = path;
+}
+
+const std::string& MeshCache::getDirectory(){
+    return directory;
+}
+
+void MeshCache::setVertexLayout(const VertexLayout& layout){
+    vertexLayout = layout;
+}
+
+const VertexLayout& MeshCache::getVertexLayout(){
+    return vertexLayout;
+}
+
+void MeshCache::setLODRatios(const vector<float>& ratios){
+    lodRatios = ratios;
+}
+
+const vector<float>& MeshCache::getLODRatios(){
+    return lodRatios;
+}
@@ -0,0 +1,49 @@
+/*
+    Keeps the cooked version of every loaded OBJ file in a cache directory.
+    Cooked files are named after the hash of the source file's content (and of
+    the cooking settings), so an edited OBJ is cooked again while an unchanged one
+    is never parsed twice, whatever its path or modification time.
+*/
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <string>
+
+#include "CookedMesh.h"
+
+class JobSystem;
+
+class MeshCache
+{
+    public:
+
+        // Loads the cooked version of the OBJ file, cooking it first if it is not
+        // in the cache. The job system, if any, parses the OBJ in parallel.
+        // Cooking optimizes the mesh (see MeshOptimizer) and prints its ACMR and ATVR,
+        // then builds its levels of detail (see MeshSimplifier).
+        static bool load(const std::string& objPath, CookedMesh& mesh, JobSystem* jobSystem = nullptr);
+
+        // The path of the cooked file for the cache key (see load()).
+        static std::string getCookedPath(uint64_t key);
+
+        // The layout meshes are cooked with, VertexLayout::compact() by default.
+        static void setVertexLayout(const VertexLayout& layout);
+        static const VertexLayout& getVertexLayout();
+
+        // The triangle ratios of the levels of detail after the full mesh, e.g. 0.5 for
+        // half the triangles. 50%, 25% and 10% by default, empty for no levels of detail.
+        static void setLODRatios(const vector<float>& ratios);
+        static const vector<float>& getLODRatios();
+
+        // Where cooked files are kept. Created when the first mesh is cooked.
+        static void setDirectory(const std::string& directory);
+        static const std::string& getDirectory();
+
+    private:
+        static std::string directory;
+        static VertexLayout vertexLayout;
+        static vector<float> lodRatios;
+};
+
+#endif // MESHCACHE_H
@@ -0,0 +1,330 @@
+#include "MeshOptimizer.h"
+#include "Profiler.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+
+// The cache simulated by the vertex cache optimization, and the weights of its scores.
+// The values are the ones tuned by Forsyth.
+static const unsigned FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+// Vertices in the cache score higher, and so do vertices with few triangles
+// left, so lone triangles are not left behind.
+static float forsythVertexScore(int cachePosition, unsigned remainingTriangles){
+    if (remainingTriangles == 0)
+        return -1;
+
+    float score = 0;
+    if (cachePosition >= 0){
+
+        // The vertices of the last triangle get a fixed score, so the next
+        // triangle does not reuse the same edge too eagerly.
+        if (cachePosition < 3)
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        else
+            score = powf(1 - (cachePosition - 3) / float(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+    }
+
+    return score + FORSYTH_VALENCE_BOOST_SCALE * powf(float(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+}
+
+std::ostream& operator<<(std::ostream& os, const VertexCacheStats& stats){
+    std::ios::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(3) << "ACMR " << stats.acmr << ", ATVR " << stats.atvr;
+    os.flags(flags);
+    return os;
+}
+
+void MeshOptimizer::optimize(IndexedModel& model, VertexCacheStats* before, VertexCacheStats* after){
+    PROFILE_ZONE("Mesh optimize");
+
+    if (before)
+        *before = analyzeVertexCache(model.indices, model.positions.size());
+
+    optimizeVertexCache(model.indices, model.positions.size());
+    optimizeOverdraw(model.indices, model.positions);
+    optimizeVertexFetch(model);
+
+    if (after)
+        *after = analyzeVertexCache(model.indices, model.positions.size());
+}
+
+void MeshOptimizer::optimizeVertexCache(vector<unsigned>& indices, unsigned vertexCount){
+
+    unsigned triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // The triangles of each vertex, packed one vertex after the other. A vertex's
+    // list only holds its triangles not yet emitted (the first 'remaining' ones).
+    vector<unsigned> remaining(vertexCount, 0);
+    for (unsigned i = 0; i < triangleCount * 3; i++)
+        remaining[indices[i]]++;
+
+    vector<unsigned> offsets(vertexCount + 1, 0);
+    for (unsigned v = 0; v < vertexCount; v++)
+        offsets[v + 1] = offsets[v] + remaining[v];
+
+    vector<unsigned> triangles(offsets[vertexCount]);
+    vector<unsigned> filled(offsets.begin(), offsets.end() - 1);
+    for (unsigned i = 0; i < triangleCount * 3; i++)
+        triangles[filled[indices[i]]++] = i / 3;
+
+    vector<int> cachePositions(vertexCount, -1);
+    vector<float> vertexScores(vertexCount);
+    for (unsigned v = 0; v < vertexCount; v++)
+        vertexScores[v] = forsythVertexScore(-1, remaining[v]);
+
+    vector<float> triangleScores(triangleCount);
+    vector<unsigned char> emitted(triangleCount, 0);
+
+    int best = 0;
+    for (unsigned t = 0; t < triangleCount; t++){
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[best])
+            best = t;
+    }
+
+    vector<unsigned> result;
+    result.reserve(triangleCount * 3);
+
+    // The cache holds up to 3 more vertices while it is being updated.
+    unsigned cache[FORSYTH_CACHE_SIZE + 3];
+    unsigned newCache[FORSYTH_CACHE_SIZE + 3];
+    unsigned cacheCount = 0;
+
+    // Where to look for a triangle when none around the cache is left.
+    unsigned nextUnemitted = 0;
+
+    while (best >= 0){
+        const unsigned* triangle = &indices[best * 3];
+        emitted[best] = 1;
+
+        // The triangle's vertices move to the front of the cache.
+        unsigned newCacheCount = 0;
+        for (unsigned i = 0; i < 3; i++){
+            unsigned v = triangle[i];
+            result.push_back(v);
+            newCache[newCacheCount++] = v;
+
+            // Remove the triangle from the vertex's list.
+            unsigned* list = &triangles[offsets[v]];
+            for (unsigned j = 0; j < remaining[v]; j++){
+                if (list[j] == unsigned(best)){
+                    list[j] = list[remaining[v] - 1];
+                    remaining[v]--;
+                    break;
+                }
+            }
+        }
+
+        for (unsigned i = 0; i < cacheCount; i++){
+            unsigned v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache[newCacheCount++] = v;
+        }
+
+        // Rescore the vertices in the cache, and those that just fell out of it.
+        for (unsigned i = 0; i < newCacheCount; i++){
+            unsigned v = newCache[i];
+            cachePositions[v] = i < FORSYTH_CACHE_SIZE ? int(i) : -1;
+            vertexScores[v] = forsythVertexScore(cachePositions[v], remaining[v]);
+        }
+
+        // Only the triangles of those vertices changed score, so the best one is among them.
+        best = -1;
+        float bestScore = -1;
+
+        for (unsigned i = 0; i < newCacheCount; i++){
+            unsigned v = newCache[i];
+            const unsigned* list = &triangles[offsets[v]];
+
+            for (unsigned j = 0; j < remaining[v]; j++){
+                unsigned t = list[j];
+                float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+                triangleScores[t] = score;
+
+                if (score > bestScore){
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCacheCount, FORSYTH_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        // Nothing around the cache is left. Continue from any triangle not yet emitted.
+        if (best < 0){
+            while (nextUnemitted < triangleCount && emitted[nextUnemitted])
+                nextUnemitted++;
+
+            if (nextUnemitted < triangleCount)
+                best = nextUnemitted;
+        }
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(vector<unsigned>& indices, const vector<Vector3>& positions, float threshold){
+
+    unsigned triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // A cluster starts on every triangle whose 3 vertices missed the cache, since
+    // the cache had nothing to share with the triangles before it anyway.
+    const unsigned cacheSize = 16;
+    vector<unsigned> timestamps(positions.size(), 0);
+    unsigned time = cacheSize + 1;
+
+    vector<unsigned> clusterStarts;
+    for (unsigned t = 0; t < triangleCount; t++){
+        unsigned misses = 0;
+        for (unsigned i = 0; i < 3; i++){
+            unsigned v = indices[t * 3 + i];
+            if (time - timestamps[v] > cacheSize){
+                timestamps[v] = time++;
+                misses++;
+            }
+        }
+
+        if (t == 0 || misses == 3)
+            clusterStarts.push_back(t);
+    }
+
+    unsigned clusterCount = clusterStarts.size();
+    if (clusterCount < 2)
+        return;
+    clusterStarts.push_back(triangleCount);
+
+    // The area weighted center and normal of every cluster, and of the whole mesh.
+    vector<Vector3> clusterCenters(clusterCount);
+    vector<Vector3> clusterNormals(clusterCount);
+    Vector3 meshCenter;
+    float meshArea = 0;
+
+    for (unsigned c = 0; c < clusterCount; c++){
+        Vector3 center;
+        Vector3 normal;
+        float area = 0;
+
+        for (unsigned t = clusterStarts[c]; t < clusterStarts[c + 1]; t++){
+            const Vector3& a = positions[indices[t * 3]];
+            const Vector3& b = positions[indices[t * 3 + 1]];
+            const Vector3& d = positions[indices[t * 3 + 2]];
+
+            // The cross product's length is twice the area of the triangle.
+            Vector3 edge = b - a;
+            Vector3 cross = edge.cross(d - a);
+            float triangleArea = cross.magnitude();
+
+            center += (a + b + d) * (triangleArea / 3);
+            normal += cross;
+            area += triangleArea;
+        }
+
+        meshCenter += center;
+        meshArea += area;
+
+        if (area > 0)
+            clusterCenters[c] = center * (1 / area);
+        else
+            clusterCenters[c] = positions[indices[clusterStarts[c] * 3]];
+        clusterNormals[c] = normal;
+    }
+
+    if (meshArea > 0)
+        meshCenter = meshCenter * (1 / meshArea);
+
+    // Clusters facing away from the center are likely in front of the others.
+    vector<float> sortKeys(clusterCount);
+    vector<unsigned> order(clusterCount);
+
+    for (unsigned c = 0; c < clusterCount; c++){
+        float length = clusterNormals[c].magnitude();
+        sortKeys[c] = length > 0 ? (clusterCenters[c] - meshCenter).dot(clusterNormals[c]) / length : 0;
+        order[c] = c;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](unsigned a, unsigned b){
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    vector<unsigned> result;
+    result.reserve(indices.size());
+
+    for (unsigned c : order)
+        result.insert(result.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+
+    // The clusters do not start on an empty cache once reordered, so check the cost.
+    unsigned oldMisses = analyzeVertexCache(indices, positions.size(), cacheSize).cacheMisses;
+    unsigned newMisses = analyzeVertexCache(result, positions.size(), cacheSize).cacheMisses;
+
+    if (newMisses <= oldMisses * threshold)
+        std::copy(result.begin(), result.end(), indices.begin());
+}
+
+// Moves the elements to their new index. Arrays of another size than the vertex
+// count (e.g. no uvs) are left as they are.
+template<typename T>
+static void remapVertices(vector<T>& attributes, const vector<unsigned>& remap, unsigned newCount){
+    if (attributes.size() != remap.size())
+        return;
+
+    vector<T> result(newCount);
+    for (unsigned v = 0; v < remap.size(); v++)
+        if (remap[v] < newCount)
+            result[remap[v]] = attributes[v];
+
+    attributes.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(IndexedModel& model){
+
+    const unsigned unused = 0xFFFFFFFF;
+
+    vector<unsigned> remap(model.positions.size(), unused);
+    unsigned nextVertex = 0;
+
+    for (unsigned& index : model.indices){
+        if (remap[index] == unused)
+            remap[index] = nextVertex++;
+        index = remap[index];
+    }
+
+    remapVertices(model.positions, remap, nextVertex);
+    remapVertices(model.texCoords, remap, nextVertex);
+    remapVertices(model.normals, remap, nextVertex);
+    remapVertices(model.tangents, remap, nextVertex);
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const vector<unsigned>& indices, unsigned vertexCount, unsigned cacheSize){
+
+    VertexCacheStats stats;
+    stats.vertexCount = vertexCount;
+    stats.triangleCount = indices.size() / 3;
+    stats.cacheMisses = 0;
+
+    // A vertex is still in a FIFO cache if fewer than cacheSize vertices were added after it.
+    vector<unsigned> timestamps(vertexCount, 0);
+    unsigned time = cacheSize + 1;
+
+    for (unsigned i = 0; i < stats.triangleCount * 3; i++){
+        unsigned v = indices[i];
+        if (time - timestamps[v] > cacheSize){
+            timestamps[v] = time++;
+            stats.cacheMisses++;
+        }
+    }
+
+    stats.acmr = stats.triangleCount > 0 ? float(stats.cacheMisses) / stats.triangleCount : 0;
+    stats.atvr = vertexCount > 0 ? float(stats.cacheMisses) / vertexCount : 0;
+    return stats;
+}
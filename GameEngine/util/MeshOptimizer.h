@@ -0,0 +1,61 @@
+/*
+    Reorders the triangles and vertices of a mesh so the GPU does less work drawing it,
+    without changing what is drawn. Meant to run once, when a mesh is imported or cooked.
+*/
+
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <vector>
+#include <ostream>
+
+#include "OBJModel.h"
+#include "../math/Vector3.h"
+
+using std::vector;
+
+// How well a triangle order uses the post-transform vertex cache.
+struct VertexCacheStats
+{
+    unsigned vertexCount;
+    unsigned triangleCount;
+
+    // Vertices that had to be transformed again because they were not in the cache.
+    unsigned cacheMisses;
+
+    // Average cache miss ratio: vertices transformed per triangle. 0.5 to 3, lower is better.
+    float acmr;
+
+    // Average transform to vertex ratio: how often each vertex is transformed. 1 is optimal.
+    float atvr;
+};
+
+std::ostream& operator<<(std::ostream&, const VertexCacheStats&);
+
+class MeshOptimizer
+{
+    public:
+
+        // Runs all the steps below on the model, in order.
+        // The stats before and after are returned if requested.
+        static void optimize(IndexedModel& model, VertexCacheStats* before = nullptr, VertexCacheStats* after = nullptr);
+
+        // Reorders the triangles so the vertices they share are still in the vertex cache
+        // (Tom Forsyth's linear speed vertex cache optimization).
+        static void optimizeVertexCache(vector<unsigned>& indices, unsigned vertexCount);
+
+        // Reorders clusters of triangles so the ones facing outward are drawn first and hide
+        // the ones behind them. Clusters start where the vertex cache was emptied anyway, so
+        // the cache is barely affected. The new order is kept only if it has at most
+        // 'threshold' times the cache misses of the current one.
+        static void optimizeOverdraw(vector<unsigned>& indices, const vector<Vector3>& positions, float threshold = 1.05f);
+
+        // Renumbers the vertices in the order the indices first use them, so vertex
+        // fetches walk through memory. Vertices no index uses are removed.
+        static void optimizeVertexFetch(IndexedModel& model);
+
+        // Simulates a FIFO vertex cache of the given size over the triangles.
+        static VertexCacheStats analyzeVertexCache(const vector<unsigned>& indices, unsigned vertexCount, unsigned cacheSize = 16);
+};
+
+#endif // MESHOPTIMIZER_H
@@ -0,0 +1,333 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "Profiler.h"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <iterator>
+
+const unsigned MeshSimplifier::MAX_LODS;
+
+// The sum of the squared distances to a set of planes, as a symmetric 4x4 matrix.
+// Planes are weighted by the area of their triangle, and the error is divided by
+// the total weight, so it is the mean squared distance. Cheap enough to rank every
+// candidate collapse, but not a bound: see maxPlaneDistance().
+struct Quadric
+{
+    double a2, ab, ac, ad;
+    double b2, bc, bd;
+    double c2, cd;
+    double d2;
+    double weight;
+
+    Quadric() : a2(0), ab(0), ac(0), ad(0), b2(0), bc(0), bd(0), c2(0), cd(0), d2(0), weight(0) {}
+
+    // The plane a*x + b*y + c*z + d = 0, with (a, b, c) of unit length.
+    Quadric(double a, double b, double c, double d, double weight) :
+        a2(a*a*weight), ab(a*b*weight), ac(a*c*weight), ad(a*d*weight),
+        b2(b*b*weight), bc(b*c*weight), bd(b*d*weight),
+        c2(c*c*weight), cd(c*d*weight),
+        d2(d*d*weight), weight(weight)
+    {}
+
+    void operator+=(const Quadric& q){
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+    }
+
+    double error(const Vector3& p) const{
+        double x = p.x, y = p.y, z = p.z;
+        double sum = x*x*a2 + 2*x*y*ab + 2*x*z*ac + 2*x*ad
+                   + y*y*b2 + 2*y*z*bc + 2*y*bd
+                   + z*z*c2 + 2*z*cd
+                   + d2;
+
+        return weight > 0 ? std::fabs(sum) / weight : 0;
+    }
+};
+
+struct Collapse
+{
+    unsigned from;
+    unsigned to;
+    double error;
+
+    bool operator<(const Collapse& other) const { return error < other.error; }
+};
+
+// The normal of the triangle, scaled by twice its area.
+static Vector3 triangleNormal(const Vector3& a, const Vector3& b, const Vector3& c){
+    Vector3 edge = b - a;
+    return edge.cross(c - a);
+}
+
+// A plane a*x + b*y + c*z + d = 0, with (a, b, c) of unit length.
+struct Plane
+{
+    Vector3 normal;
+    float d;
+};
+
+// The largest distance from the point to any of the planes.
+static float maxPlaneDistance(const vector<Plane>& planes, const vector<unsigned>& planeIndices, const Vector3& point){
+    float distance = 0;
+    for (unsigned index : planeIndices){
+        const Plane& plane = planes[index];
+        distance = std::max(distance, std::fabs(plane.normal.dot(point) + plane.d));
+    }
+    return distance;
+}
+
+// Marks the vertices of edges that are not shared by exactly two triangles, one in
+// each direction. These are on a border, a seam, or a non manifold part of the mesh.
+static void findLockedVertices(const vector<unsigned>& indices, vector<unsigned char>& locked){
+
+    std::unordered_map<uint64_t, unsigned> edges;
+    edges.reserve(indices.size());
+
+    for (unsigned i = 0; i < indices.size(); i += 3)
+        for (unsigned j = 0; j < 3; j++)
+            edges[(uint64_t(indices[i + j]) << 32) | indices[i + (j + 1) % 3]]++;
+
+    for (const auto& edge : edges){
+        unsigned a = unsigned(edge.first >> 32);
+        unsigned b = unsigned(edge.first & 0xFFFFFFFF);
+
+        auto opposite = edges.find((uint64_t(b) << 32) | a);
+        if (edge.second != 1 || opposite == edges.end() || opposite->second != 1){
+            locked[a] = 1;
+            locked[b] = 1;
+        }
+    }
+}
+
+float MeshSimplifier::simplify(const vector<Vector3>& positions, const vector<unsigned>& indices,
+                               unsigned targetIndexCount, float maxError, vector<unsigned>& result){
+    PROFILE_ZONE("Mesh simplify");
+
+    unsigned vertexCount = positions.size();
+    result.assign(indices.begin(), indices.end() - indices.size() % 3);
+
+    vector<unsigned char> locked(vertexCount, 0);
+    findLockedVertices(result, locked);
+
+    // The planes of the source triangles, and the ones each vertex was merged with.
+    // Their largest distance to the vertex is the error reported for the collapses.
+    vector<Plane> planes;
+    vector<vector<unsigned> > vertexPlanes(vertexCount);
+
+    vector<Quadric> quadrics(vertexCount);
+    for (unsigned i = 0; i < result.size(); i += 3){
+        const Vector3& p0 = positions[result[i]];
+        Vector3 normal = triangleNormal(p0, positions[result[i + 1]], positions[result[i + 2]]);
+
+        float doubleArea = normal.magnitude();
+        if (doubleArea <= 0)
+            continue;
+
+        normal = normal * (1 / doubleArea);
+        Quadric plane(normal.x, normal.y, normal.z, -normal.dot(p0), doubleArea * 0.5);
+
+        Plane source = { normal, -normal.dot(p0) };
+        planes.push_back(source);
+
+        for (unsigned j = 0; j < 3; j++){
+            quadrics[result[i + j]] += plane;
+            vertexPlanes[result[i + j]].push_back(planes.size() - 1);
+        }
+    }
+
+    // The mean squared distance never exceeds the largest squared distance, so
+    // candidates above it can not pass the check below either.
+    double maxErrorSquared = double(maxError) * maxError;
+    float worstError = 0;
+    vector<unsigned> mergedPlanes;
+
+    vector<unsigned> offsets(vertexCount + 1);
+    vector<unsigned> filled(vertexCount);
+    vector<unsigned> adjacency;
+    vector<Collapse> collapses;
+    vector<unsigned char> touched(vertexCount);
+    vector<unsigned> remap(vertexCount);
+
+    // Collapses are done in passes. Each pass finds the cheapest collapse of every
+    // vertex and applies them in order, skipping the ones around vertices already
+    // moved in the pass, since their costs are out of date.
+    while (result.size() > targetIndexCount){
+        unsigned triangleCount = result.size() / 3;
+
+        // The triangles around each vertex.
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (unsigned index : result)
+            offsets[index + 1]++;
+        for (unsigned v = 0; v < vertexCount; v++)
+            offsets[v + 1] += offsets[v];
+
+        adjacency.resize(result.size());
+        std::copy(offsets.begin(), offsets.end() - 1, filled.begin());
+        for (unsigned i = 0; i < result.size(); i++)
+            adjacency[filled[result[i]]++] = i / 3;
+
+        collapses.clear();
+        for (unsigned v = 0; v < vertexCount; v++){
+            if (locked[v] || offsets[v] == offsets[v + 1])
+                continue;
+
+            Collapse best = { v, v, 0 };
+            for (unsigned k = offsets[v]; k < offsets[v + 1]; k++){
+                const unsigned* triangle = &result[adjacency[k] * 3];
+
+                for (unsigned j = 0; j < 3; j++){
+                    unsigned to = triangle[j];
+                    if (to == v)
+                        continue;
+
+                    Quadric merged = quadrics[v];
+                    merged += quadrics[to];
+                    double error = merged.error(positions[to]);
+
+                    if (best.to == v || error < best.error){
+                        best.to = to;
+                        best.error = error;
+                    }
+                }
+            }
+
+            if (best.to != v && best.error <= maxErrorSquared)
+                collapses.push_back(best);
+        }
+
+        std::sort(collapses.begin(), collapses.end());
+
+        std::fill(touched.begin(), touched.end(), 0);
+        for (unsigned v = 0; v < vertexCount; v++)
+            remap[v] = v;
+
+        unsigned removedTriangles = 0;
+        unsigned applied = 0;
+
+        for (const Collapse& collapse : collapses){
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            // Reject collapses that flip a triangle over.
+            bool flips = false;
+            unsigned degenerate = 0;
+
+            for (unsigned k = offsets[collapse.from]; k < offsets[collapse.from + 1] && !flips; k++){
+                const unsigned* triangle = &result[adjacency[k] * 3];
+
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to){
+                    degenerate++;
+                    continue;
+                }
+
+                Vector3 corners[3];
+                for (unsigned j = 0; j < 3; j++)
+                    corners[j] = positions[triangle[j]];
+
+                Vector3 before = triangleNormal(corners[0], corners[1], corners[2]);
+                for (unsigned j = 0; j < 3; j++)
+                    if (triangle[j] == collapse.from)
+                        corners[j] = positions[collapse.to];
+                Vector3 after = triangleNormal(corners[0], corners[1], corners[2]);
+
+                flips = before.dot(after) <= 0;
+            }
+
+            if (flips)
+                continue;
+
+            // The target vertex stays where it is, so only the planes of the moved
+            // vertex can be further away than before.
+            float error = maxPlaneDistance(planes, vertexPlanes[collapse.from], positions[collapse.to]);
+            if (error > maxError)
+                continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            worstError = std::max(worstError, error);
+
+            // Both lists are sorted, since planes are only ever added in order or merged.
+            vector<unsigned>& fromPlanes = vertexPlanes[collapse.from];
+            vector<unsigned>& toPlanes = vertexPlanes[collapse.to];
+            mergedPlanes.clear();
+            std::set_union(toPlanes.begin(), toPlanes.end(), fromPlanes.begin(), fromPlanes.end(), std::back_inserter(mergedPlanes));
+            toPlanes.swap(mergedPlanes);
+            vector<unsigned>().swap(fromPlanes);
+
+            for (unsigned k = offsets[collapse.from]; k < offsets[collapse.from + 1]; k++)
+                for (unsigned j = 0; j < 3; j++)
+                    touched[result[adjacency[k] * 3 + j]] = 1;
+
+            applied++;
+            removedTriangles += degenerate;
+            if ((triangleCount - removedTriangles) * 3 <= targetIndexCount)
+                break;
+        }
+
+        if (applied == 0)
+            break;
+
+        // Move the collapsed vertices and drop the triangles that became degenerate.
+        unsigned written = 0;
+        for (unsigned i = 0; i < result.size(); i += 3){
+            unsigned a = remap[result[i]];
+            unsigned b = remap[result[i + 1]];
+            unsigned c = remap[result[i + 2]];
+
+            if (a == b || b == c || c == a)
+                continue;
+
+            result[written++] = a;
+            result[written++] = b;
+            result[written++] = c;
+        }
+
+        result.resize(written);
+    }
+
+    return worstError;
+}
+
+vector<MeshLOD> MeshSimplifier::buildLODChain(IndexedModel& model, const vector<float>& triangleRatios, float maxError){
+    PROFILE_ZONE("Mesh LODs");
+
+    unsigned fullIndexCount = model.indices.size();
+
+    vector<MeshLOD> lods;
+    MeshLOD full = { 0, fullIndexCount, 0 };
+    lods.push_back(full);
+
+    // Every level is simplified from the previous one, which is much faster than
+    // starting over from the full mesh. Their errors add up.
+    vector<unsigned> previous(model.indices);
+    vector<unsigned> simplified;
+
+    for (unsigned i = 0; i < triangleRatios.size() && lods.size() < MAX_LODS; i++){
+        unsigned target = unsigned(fullIndexCount / 3 * triangleRatios[i]) * 3;
+        if (target >= previous.size())
+            continue;
+
+        float error = simplify(model.positions, previous, target, maxError, simplified);
+
+        // Nothing left that can be collapsed.
+        if (simplified.size() == previous.size() || simplified.empty())
+            break;
+
+        MeshOptimizer::optimizeVertexCache(simplified, model.positions.size());
+
+        MeshLOD lod = { (unsigned)model.indices.size(), (unsigned)simplified.size(), lods.back().error + error };
+        lods.push_back(lod);
+
+        model.indices.insert(model.indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+
+    return lods;
+}
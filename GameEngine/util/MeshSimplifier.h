@@ -0,0 +1,54 @@
+/*
+    Reduces the triangles of a mesh by collapsing edges in the order of the least
+    error they add, measured with quadric error metrics (Garland and Heckbert).
+    A collapse moves a vertex onto one of its neighbors instead of a new position,
+    so every level of detail indexes the same vertex array and only needs its own
+    index list.
+*/
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <vector>
+#include <cfloat>
+
+#include "OBJModel.h"
+#include "../math/Vector3.h"
+
+using std::vector;
+
+// One level of detail: a range of the mesh's indices.
+struct MeshLOD
+{
+    unsigned firstIndex;
+    unsigned indexCount;
+
+    // The largest distance between a vertex and the plane of a full mesh triangle
+    // it was merged with, in model space units. A conservative measure for picking
+    // levels, not an exact bound of the distance between the two surfaces.
+    float error;
+};
+
+class MeshSimplifier
+{
+    public:
+
+        // The most levels a mesh can have, the full mesh included.
+        static const unsigned MAX_LODS = 8;
+
+        // Collapses edges until at most targetIndexCount indices are left, or every
+        // remaining collapse would move a vertex further than maxError from the plane
+        // of a source triangle it was merged with. Vertices on borders, and on uv or
+        // normal seams (where vertices are split), are never moved so the mesh does not tear.
+        // Returns the largest such distance, in model space units.
+        static float simplify(const vector<Vector3>& positions, const vector<unsigned>& indices,
+                              unsigned targetIndexCount, float maxError, vector<unsigned>& result);
+
+        // Appends a simplified copy of the triangles to the model's indices for each
+        // ratio (of the full triangle count, decreasing). Level 0 is the full mesh.
+        // Stops early once a level can not be simplified any further.
+        static vector<MeshLOD> buildLODChain(IndexedModel& model, const vector<float>& triangleRatios,
+                                             float maxError = FLT_MAX);
+};
+
+#endif // MESHSIMPLIFIER_H
@@ -2,408 +2,814 @@
 // The code has been modified to work with Cor's math classes
 
 #include "OBJModel.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "../core/JobSystem.h"
 
-#include <fstream>
 #include <iostream>
 #include <algorithm>
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
 
-static bool CompareOBJIndexPtr(const OBJIndex* a, const OBJIndex* b);
-static inline unsigned int FindNextChar(unsigned int start, const char* str, unsigned int length, char token);
-static inline unsigned int ParseOBJIndexValue(const std::string& token, unsigned int start, unsigned int end);
-static inline float ParseOBJFloatValue(const std::string& token, unsigned int start, unsigned int end);
-static inline std::vector<std::string> SplitString(const std::string &s, char delim);
+// The smallest part of a file handed to one job.
+static const size_t OBJ_MIN_CHUNK_SIZE = 512 * 1024;
 
-OBJModel::OBJModel(const std::string& fileName)
+// Which components of a face vertex were given as negative (relative) indices.
+enum OBJRelativeComponents
 {
-	hasUVs = false;
-	hasNormals = false;
-    std::ifstream file;
-    file.open(fileName.c_str());
+    OBJ_RELATIVE_VERTEX = 1,
+    OBJ_RELATIVE_UV = 2,
+    OBJ_RELATIVE_NORMAL = 4
+};
+
+struct OBJRelativeIndex
+{
+    unsigned int position;
+    unsigned int components;
+};
+
+// What one chunk of the file contains. Face indices are already 0 based.
+// Negative (relative) indices are stored relative to the start of the chunk and
+// listed in relativeIndices, so the merge can add the counts of the previous chunks.
+struct OBJChunk
+{
+    const char* begin;
+    const char* end;
+
+    std::vector<Vector3> vertices;
+    std::vector<Vector2> uvs;
+    std::vector<Vector3> normals;
+    std::vector<OBJIndex> indices;
+    std::vector<OBJRelativeIndex> relativeIndices;
+    bool hasUVs;
+    bool hasNormals;
+};
+
+static void ParseOBJChunk(OBJChunk& chunk);
 
-    std::string line;
-    if(file.is_open())
+// Maps the distinct (position, uv, normal) index triples to their vertex.
+// Open addressing with linear probing in one flat array, so lookups cost O(1)
+// on average and nothing is allocated per vertex. The table starts from an
+// estimate of the vertex count and doubles whenever it gets 70% full.
+class OBJVertexTable
+{
+public:
+    static const unsigned int EMPTY = 0xFFFFFFFF;
+
+    OBJVertexTable(unsigned int expectedVertices, bool useUVs, bool useNormals) :
+        count(0), useUVs(useUVs), useNormals(useNormals)
     {
-        while(file.good())
-        {
-            getline(file, line);
+        unsigned int capacity = 16;
+        while(capacity * 7 / 10 < expectedVertices)
+            capacity *= 2;
 
-            unsigned int lineLength = line.length();
+        Resize(capacity);
+    }
 
-            if(lineLength < 2)
-                continue;
+    // Returns the vertex of the triple, or adds the triple as newVertex.
+    unsigned int insert(const OBJIndex& index, unsigned int newVertex)
+    {
+        OBJIndex key = index;
+        if(!useUVs)
+            key.uvIndex = 0;
+        if(!useNormals)
+            key.normalIndex = 0;
 
-            const char* lineCStr = line.c_str();
+        for(unsigned int i = Hash(key) & mask; ; i = (i + 1) & mask)
+        {
+            Slot& slot = slots[i];
 
-            switch(lineCStr[0])
+            if(slot.vertex == EMPTY)
             {
-                case 'v':
-                    if(lineCStr[1] == 't')
-                        this->uvs.push_back(ParseOBJVec2(line));
-                    else if(lineCStr[1] == 'n')
-                        this->normals.push_back(ParseOBJVec3(line));
-                    else if(lineCStr[1] == ' ' || lineCStr[1] == '\t')
-                        this->vertices.push_back(ParseOBJVec3(line));
-                break;
-                case 'f':
-                    CreateOBJFace(line);
-                break;
-                default: break;
-            };
+                slot.key = key;
+                slot.vertex = newVertex;
+
+                if(++count > slots.size() * 7 / 10)
+                    Resize(slots.size() * 2);
+
+                return newVertex;
+            }
+
+            if(slot.key.vertexIndex == key.vertexIndex && slot.key.uvIndex == key.uvIndex
+               && slot.key.normalIndex == key.normalIndex)
+                return slot.vertex;
         }
     }
-    else
+
+private:
+    struct Slot
     {
-        std::cerr << "Unable to load mesh: " << fileName << std::endl;
+        OBJIndex key;
+        unsigned int vertex;
+    };
+
+    static unsigned int Hash(const OBJIndex& key)
+    {
+        // Multiplicative mixing, then fold the high bits down into the mask.
+        uint64_t hash = key.vertexIndex * 0x9E3779B97F4A7C15ull;
+        hash ^= key.uvIndex * 0xC2B2AE3D27D4EB4Full;
+        hash ^= key.normalIndex * 0x165667B19E3779F9ull;
+        return (unsigned int)(hash ^ (hash >> 29) ^ (hash >> 47));
     }
-}
 
-void IndexedModel::CalcNormals()
-{
-    for(unsigned int i = 0; i < indices.size(); i += 3)
+    // Moves the entries into a table of the given power of two size.
+    void Resize(unsigned int capacity)
     {
-        int i0 = indices[i];
-        int i1 = indices[i + 1];
-        int i2 = indices[i + 2];
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        mask = capacity - 1;
 
-        Vector3 v1 = positions[i1] - positions[i0];
-        Vector3 v2 = positions[i2] - positions[i0];
+        for(Slot& slot : slots)
+            slot.vertex = EMPTY;
 
-        Vector3 normal = ( v1.cross(v2) ).normal();
+        for(const Slot& entry : old)
+        {
+            if(entry.vertex == EMPTY)
+                continue;
 
-        normals[i0] += normal;
-        normals[i1] += normal;
-        normals[i2] += normal;
+            unsigned int i = Hash(entry.key) & mask;
+            while(slots[i].vertex != EMPTY)
+                i = (i + 1) & mask;
+            slots[i] = entry;
+        }
     }
 
-    for(unsigned int i = 0; i < positions.size(); i++)
-        normals[i] = normals[i].normal();
-}
+    std::vector<Slot> slots;
+    unsigned int mask;
+    unsigned int count;
+    bool useUVs;
+    bool useNormals;
+};
 
-IndexedModel OBJModel::ToIndexedModel()
-{
-    IndexedModel result;
-    IndexedModel normalModel;
+const unsigned int OBJVertexTable::EMPTY;
 
-    unsigned int numIndices = OBJIndices.size();
+OBJModel::OBJModel(const std::string& fileName, JobSystem* jobSystem)
+{
+    PROFILE_ZONE("OBJ parse");
+    hasUVs = false;
+    hasNormals = false;
 
-    std::vector<OBJIndex*> indexLookup;
+    MappedFile file;
+    if(!file.open(fileName))
+    {
+        std::cerr << "Unable to load mesh: " << fileName << std::endl;
+        return;
+    }
 
-    for(unsigned int i = 0; i < numIndices; i++)
-        indexLookup.push_back(&OBJIndices[i]);
+    const char* data = file.getData();
+    size_t size = file.getSize();
 
-    std::sort(indexLookup.begin(), indexLookup.end(), CompareOBJIndexPtr);
+    // Cut the file into chunks that end right after a line break.
+    size_t maxChunks = jobSystem ? (jobSystem->getWorkerCount() + 1) * 4 : 1;
+    size_t chunkCount = std::max<size_t>(1, std::min(maxChunks, size / OBJ_MIN_CHUNK_SIZE));
 
-    std::map<OBJIndex, unsigned int> normalModelIndexMap;
-    std::map<unsigned int, unsigned int> indexMap;
+    std::vector<OBJChunk> chunks(chunkCount);
+    const char* chunkBegin = data;
 
-    for(unsigned int i = 0; i < numIndices; i++)
+    for(size_t i = 0; i < chunkCount; i++)
     {
-        OBJIndex* currentIndex = &OBJIndices[i];
+        const char* chunkEnd = data + size;
 
-        Vector3 currentPosition = vertices[currentIndex->vertexIndex];
-        Vector2 currentTexCoord;
-        Vector3 currentNormal;
+        if(i + 1 < chunkCount)
+        {
+            const char* target = std::max(chunkBegin, data + size * (i + 1) / chunkCount);
+            const char* lineBreak = static_cast<const char*>(memchr(target, '\n', data + size - target));
+            chunkEnd = lineBreak ? lineBreak + 1 : data + size;
+        }
 
-        if(hasUVs)
-            currentTexCoord = uvs[currentIndex->uvIndex];
-        else
-            currentTexCoord = Vector2();
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
 
-        if(hasNormals)
-            currentNormal = normals[currentIndex->normalIndex];
-        else
-            currentNormal = Vector3();
+    if(jobSystem && chunkCount > 1)
+        jobSystem->parallelFor(0, chunkCount, 1, [&chunks](unsigned first, unsigned last)
+        {
+            for(unsigned i = first; i < last; i++)
+                ParseOBJChunk(chunks[i]);
+        });
+    else
+        ParseOBJChunk(chunks[0]);
 
-        unsigned int normalModelIndex;
-        unsigned int resultModelIndex;
+    // Merge the chunks in file order.
+    size_t numVertices = 0, numUVs = 0, numNormals = 0, numIndices = 0;
+    for(const OBJChunk& chunk : chunks)
+    {
+        numVertices += chunk.vertices.size();
+        numUVs += chunk.uvs.size();
+        numNormals += chunk.normals.size();
+        numIndices += chunk.indices.size();
+    }
 
-        //Create model to properly generate normals on
-        std::map<OBJIndex, unsigned int>::iterator it = normalModelIndexMap.find(*currentIndex);
-        if(it == normalModelIndexMap.end())
-        {
-            normalModelIndex = normalModel.positions.size();
+    vertices.reserve(numVertices);
+    uvs.reserve(numUVs);
+    normals.reserve(numNormals);
+    OBJIndices.reserve(numIndices);
 
-            normalModelIndexMap.insert(std::pair<OBJIndex, unsigned int>(*currentIndex, normalModelIndex));
-            normalModel.positions.push_back(currentPosition);
-            normalModel.texCoords.push_back(currentTexCoord);
-            normalModel.normals.push_back(currentNormal);
-        }
-        else
-            normalModelIndex = it->second;
+    for(const OBJChunk& chunk : chunks)
+    {
+        unsigned int vertexOffset = vertices.size();
+        unsigned int uvOffset = uvs.size();
+        unsigned int normalOffset = normals.size();
+        unsigned int indexOffset = OBJIndices.size();
 
-        //Create model which properly separates texture coordinates
-        unsigned int previousVertexLocation = FindLastVertexIndex(indexLookup, currentIndex, result);
+        vertices.insert(vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        OBJIndices.insert(OBJIndices.end(), chunk.indices.begin(), chunk.indices.end());
 
-        if(previousVertexLocation == (unsigned int)-1)
+        for(const OBJRelativeIndex& relative : chunk.relativeIndices)
         {
-            resultModelIndex = result.positions.size();
-
-            result.positions.push_back(currentPosition);
-            result.texCoords.push_back(currentTexCoord);
-            result.normals.push_back(currentNormal);
+            OBJIndex& index = OBJIndices[indexOffset + relative.position];
+
+            if(relative.components & OBJ_RELATIVE_VERTEX)
+                index.vertexIndex += vertexOffset;
+            if(relative.components & OBJ_RELATIVE_UV)
+                index.uvIndex += uvOffset;
+            if(relative.components & OBJ_RELATIVE_NORMAL)
+                index.normalIndex += normalOffset;
         }
-        else
-            resultModelIndex = previousVertexLocation;
 
-        normalModel.indices.push_back(normalModelIndex);
-        result.indices.push_back(resultModelIndex);
-        indexMap.insert(std::pair<unsigned int, unsigned int>(resultModelIndex, normalModelIndex));
+        hasUVs = hasUVs || chunk.hasUVs;
+        hasNormals = hasNormals || chunk.hasNormals;
     }
 
-    if(!hasNormals)
+    // Faces may refer to elements further down the file, so indices can only be
+    // checked once every chunk is merged. Triangles with an index out of range
+    // (e.g. 0, or past the end) are dropped.
+    unsigned int kept = 0;
+    for(unsigned int i = 0; i + 2 < OBJIndices.size(); i += 3)
     {
-        normalModel.CalcNormals();
+        bool valid = true;
+        for(unsigned int j = 0; j < 3; j++)
+        {
+            const OBJIndex& index = OBJIndices[i + j];
+            valid = valid && index.vertexIndex < vertices.size()
+                          && (!hasUVs || index.uvIndex < uvs.size())
+                          && (!hasNormals || index.normalIndex < normals.size());
+        }
 
-        for(unsigned int i = 0; i < result.positions.size(); i++)
-            result.normals[i] = normalModel.normals[indexMap[i]];
+        if(!valid)
+            continue;
+
+        for(unsigned int j = 0; j < 3; j++)
+            OBJIndices[kept + j] = OBJIndices[i + j];
+        kept += 3;
     }
 
-    return result;
-};
+    if(kept != OBJIndices.size())
+    {
+        std::cerr << "Error. Dropped " << (OBJIndices.size() - kept) / 3
+                  << " triangles with out of range indices from mesh: " << fileName << std::endl;
+        OBJIndices.resize(kept);
+    }
+}
+
+// Models with fewer vertices or triangles than this are not worth splitting over threads.
+static const unsigned int PARALLEL_ELEMENT_COUNT = 16384;
+static const unsigned int PARALLEL_GRAIN_SIZE = 4096;
 
-unsigned int OBJModel::FindLastVertexIndex(const std::vector<OBJIndex*>& indexLookup, const OBJIndex* currentIndex, const IndexedModel& result)
+// Calls func(first, last) over [0, count), split over the job system if the range is large enough.
+template<typename Func>
+static void ForEachRange(unsigned int count, JobSystem* jobSystem, Func func)
 {
-    unsigned int start = 0;
-    unsigned int end = indexLookup.size();
-    unsigned int current = (end - start) / 2 + start;
-    unsigned int previous = start;
+    if(jobSystem && count >= PARALLEL_ELEMENT_COUNT)
+        jobSystem->parallelFor(0, count, PARALLEL_GRAIN_SIZE, func);
+    else if(count > 0)
+        func(0, count);
+}
 
-    while(current != previous)
-    {
-        OBJIndex* testIndex = indexLookup[current];
+// Lists the triangle corners of each vertex: corners[offsets[v]] up to corners[offsets[v + 1]].
+// A corner is a position in the index list, so its triangle is corner / 3.
+// Vertices gather from their corners instead of triangles scattering into their
+// vertices, which lets threads work on separate vertices without sharing any sums.
+static void BuildVertexCorners(const std::vector<unsigned int>& indices, unsigned int vertexCount,
+                               std::vector<unsigned int>& offsets, std::vector<unsigned int>& corners)
+{
+    unsigned int cornerCount = indices.size() - indices.size() % 3;
+
+    offsets.assign(vertexCount + 1, 0);
+    for(unsigned int i = 0; i < cornerCount; i++)
+        offsets[indices[i] + 1]++;
+
+    for(unsigned int v = 0; v < vertexCount; v++)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    corners.resize(cornerCount);
+
+    for(unsigned int i = 0; i < cornerCount; i++)
+        corners[next[indices[i]]++] = i;
+}
+
+// The angle between two directions, 0 if either has no length.
+static float AngleBetween(const Vector3& a, const Vector3& b)
+{
+    float lengths = a.magnitude() * b.magnitude();
+    if(lengths <= 0)
+        return 0;
+
+    float cosine = a.dot(b) / lengths;
+    return acosf(std::max(-1.0f, std::min(1.0f, cosine)));
+}
+
+// Removes the part of the vector along the unit normal.
+static Vector3 ProjectOnPlane(const Vector3& v, const Vector3& normal)
+{
+    return v - normal * normal.dot(v);
+}
+
+void IndexedModel::CalcNormals(NormalWeighting weighting, JobSystem* jobSystem)
+{
+    PROFILE_ZONE("Normals");
+
+    unsigned int vertexCount = positions.size();
+    unsigned int triangleCount = indices.size() / 3;
 
-        if(testIndex->vertexIndex == currentIndex->vertexIndex)
+    // The cross product of two edges: the normal, scaled by twice the area.
+    std::vector<Vector3> faceNormals(triangleCount);
+
+    ForEachRange(triangleCount, jobSystem, [&](unsigned int first, unsigned int last)
+    {
+        for(unsigned int t = first; t < last; t++)
         {
-            unsigned int countStart = current;
+            const Vector3& p0 = positions[indices[t * 3]];
+            Vector3 v1 = positions[indices[t * 3 + 1]] - p0;
+            Vector3 v2 = positions[indices[t * 3 + 2]] - p0;
 
-            for(unsigned int i = 0; i < current; i++)
-            {
-                OBJIndex* possibleIndex = indexLookup[current - i];
+            faceNormals[t] = v1.cross(v2);
+        }
+    });
 
-                if(possibleIndex == currentIndex)
-                    continue;
+    std::vector<unsigned int> offsets, corners;
+    BuildVertexCorners(indices, vertexCount, offsets, corners);
 
-                if(possibleIndex->vertexIndex != currentIndex->vertexIndex)
-                    break;
+    normals.resize(vertexCount);
 
-                countStart--;
-            }
+    ForEachRange(vertexCount, jobSystem, [&](unsigned int first, unsigned int last)
+    {
+        for(unsigned int v = first; v < last; v++)
+        {
+            Vector3 sum;
 
-            for(unsigned int i = countStart; i < indexLookup.size() - countStart; i++)
+            for(unsigned int k = offsets[v]; k < offsets[v + 1]; k++)
             {
-                OBJIndex* possibleIndex = indexLookup[current + i];
+                unsigned int corner = corners[k];
+                unsigned int triangle = corner / 3;
 
-                if(possibleIndex == currentIndex)
+                const Vector3& faceNormal = faceNormals[triangle];
+                float doubleArea = faceNormal.magnitude();
+                if(doubleArea <= 0)
                     continue;
 
-                if(possibleIndex->vertexIndex != currentIndex->vertexIndex)
-                    break;
-                else if((!hasUVs || possibleIndex->uvIndex == currentIndex->uvIndex)
-                    && (!hasNormals || possibleIndex->normalIndex == currentIndex->normalIndex))
+                if(weighting == NORMAL_WEIGHT_AREA)
                 {
-                    Vector3 currentPosition = vertices[currentIndex->vertexIndex];
-                    Vector2 currentTexCoord;
-                    Vector3 currentNormal;
-
-                    if(hasUVs)
-                        currentTexCoord = uvs[currentIndex->uvIndex];
-                    else
-                        currentTexCoord = Vector2();
-
-                    if(hasNormals)
-                        currentNormal = normals[currentIndex->normalIndex];
-                    else
-                        currentNormal = Vector3();
-
-                    for(unsigned int j = 0; j < result.positions.size(); j++)
-                    {
-                        if(currentPosition == result.positions[j]
-                            && ((!hasUVs || currentTexCoord == result.texCoords[j])
-                            && (!hasNormals || currentNormal == result.normals[j])))
-                        {
-                            return j;
-                        }
-                    }
+                    sum += faceNormal;
+                }
+                else if(weighting == NORMAL_WEIGHT_ANGLE)
+                {
+                    const Vector3& p = positions[v];
+                    float angle = AngleBetween(positions[indices[triangle * 3 + (corner + 1) % 3]] - p,
+                                               positions[indices[triangle * 3 + (corner + 2) % 3]] - p);
+                    sum += faceNormal * (angle / doubleArea);
+                }
+                else
+                {
+                    sum += faceNormal * (1 / doubleArea);
                 }
             }
 
-            return -1;
-        }
-        else
-        {
-            if(testIndex->vertexIndex < currentIndex->vertexIndex)
-                start = current;
-            else
-                end = current;
+            // Vertices of degenerate triangles only keep a valid direction.
+            normals[v] = sum.magnitude() > 0 ? Vector3(sum.normal()) : Vector3(0, 0, 1);
         }
+    });
+}
 
-        previous = current;
-        current = (end - start) / 2 + start;
-    }
-
-    return -1;
+// Any unit vector perpendicular to the unit normal.
+static Vector3 AnyPerpendicular(const Vector3& normal)
+{
+    Vector3 axis = fabsf(normal.x) < 0.9f ? Vector3(1, 0, 0) : Vector3(0, 1, 0);
+    return ProjectOnPlane(axis, normal).normal();
 }
 
-void OBJModel::CreateOBJFace(const std::string& line)
+void IndexedModel::CalcTangents(JobSystem* jobSystem)
 {
-    std::vector<std::string> tokens = SplitString(line, ' ');
+    PROFILE_ZONE("Tangents");
+
+    unsigned int vertexCount = positions.size();
+    unsigned int triangleCount = indices.size() / 3;
 
-    this->OBJIndices.push_back(ParseOBJIndex(tokens[1], &this->hasUVs, &this->hasNormals));
-    this->OBJIndices.push_back(ParseOBJIndex(tokens[2], &this->hasUVs, &this->hasNormals));
-    this->OBJIndices.push_back(ParseOBJIndex(tokens[3], &this->hasUVs, &this->hasNormals));
+    if(normals.size() != vertexCount)
+        CalcNormals(NORMAL_WEIGHT_ANGLE, jobSystem);
 
-    if((int)tokens.size() > 4)
+    tangents.resize(vertexCount);
+
+    // Without uvs there is no tangent space to match, only a valid basis.
+    if(texCoords.size() != vertexCount)
     {
-        this->OBJIndices.push_back(ParseOBJIndex(tokens[1], &this->hasUVs, &this->hasNormals));
-        this->OBJIndices.push_back(ParseOBJIndex(tokens[3], &this->hasUVs, &this->hasNormals));
-        this->OBJIndices.push_back(ParseOBJIndex(tokens[4], &this->hasUVs, &this->hasNormals));
+        for(unsigned int v = 0; v < vertexCount; v++)
+        {
+            Vector3 tangent = AnyPerpendicular(normals[v]);
+            tangents[v] = Vector4(tangent.x, tangent.y, tangent.z, 1);
+        }
+        return;
     }
-}
 
-OBJIndex OBJModel::ParseOBJIndex(const std::string& token, bool* hasUVs, bool* hasNormals)
-{
-    unsigned int tokenLength = token.length();
-    const char* tokenString = token.c_str();
+    // The direction of increasing u on each triangle, and the sign of its uv area.
+    // Its length does not matter, only the direction is used.
+    // Triangles with no uv area have no tangent and are skipped.
+    std::vector<Vector3> faceTangents(triangleCount);
+    std::vector<float> faceSigns(triangleCount);
 
-    unsigned int vertIndexStart = 0;
-    unsigned int vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, '/');
+    ForEachRange(triangleCount, jobSystem, [&](unsigned int first, unsigned int last)
+    {
+        for(unsigned int t = first; t < last; t++)
+        {
+            unsigned int i0 = indices[t * 3];
+            unsigned int i1 = indices[t * 3 + 1];
+            unsigned int i2 = indices[t * 3 + 2];
 
-    OBJIndex result;
-    result.vertexIndex = ParseOBJIndexValue(token, vertIndexStart, vertIndexEnd);
-    result.uvIndex = 0;
-    result.normalIndex = 0;
+            Vector3 e1 = positions[i1] - positions[i0];
+            Vector3 e2 = positions[i2] - positions[i0];
+            Vector2 d1 = texCoords[i1] - texCoords[i0];
+            Vector2 d2 = texCoords[i2] - texCoords[i0];
+
+            float signedArea = d1.x * d2.y - d1.y * d2.x;
+            float sign = signedArea < 0 ? -1.0f : 1.0f;
+
+            faceSigns[t] = sign;
+            faceTangents[t] = signedArea != 0 ? Vector3((e1 * d2.y - e2 * d1.y) * sign) : Vector3();
+        }
+    });
 
-    if(vertIndexEnd >= tokenLength)
-        return result;
+    std::vector<unsigned int> offsets, corners;
+    BuildVertexCorners(indices, vertexCount, offsets, corners);
 
-    vertIndexStart = vertIndexEnd + 1;
-    vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, '/');
+    ForEachRange(vertexCount, jobSystem, [&](unsigned int first, unsigned int last)
+    {
+        for(unsigned int v = first; v < last; v++)
+        {
+            const Vector3& normal = normals[v];
+            const Vector3& p = positions[v];
 
-    result.uvIndex = ParseOBJIndexValue(token, vertIndexStart, vertIndexEnd);
-    *hasUVs = true;
+            Vector3 sum;
+            float handedness = 0;
+
+            for(unsigned int k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                unsigned int corner = corners[k];
+                unsigned int triangle = corner / 3;
 
-    if(vertIndexEnd >= tokenLength)
-        return result;
+                Vector3 tangent = ProjectOnPlane(faceTangents[triangle], normal);
+                if(tangent.magnitude() <= 0)
+                    continue;
 
-    vertIndexStart = vertIndexEnd + 1;
-    vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, '/');
+                // Like MikkTSpace, the angle is measured between the edges projected onto
+                // the tangent plane of the vertex.
+                Vector3 edge1 = ProjectOnPlane(positions[indices[triangle * 3 + (corner + 1) % 3]] - p, normal);
+                Vector3 edge2 = ProjectOnPlane(positions[indices[triangle * 3 + (corner + 2) % 3]] - p, normal);
+                float angle = AngleBetween(edge1, edge2);
 
-    result.normalIndex = ParseOBJIndexValue(token, vertIndexStart, vertIndexEnd);
-    *hasNormals = true;
+                sum += tangent.normal() * angle;
+                handedness += faceSigns[triangle] * angle;
+            }
 
-    return result;
+            Vector3 tangent = sum.magnitude() > 0 ? Vector3(sum.normal()) : AnyPerpendicular(normal);
+            tangents[v] = Vector4(tangent.x, tangent.y, tangent.z, handedness < 0 ? -1.0f : 1.0f);
+        }
+    });
 }
 
-Vector3 OBJModel::ParseOBJVec3(const std::string& line)
+IndexedModel OBJModel::ToIndexedModel(JobSystem* jobSystem)
 {
-    unsigned int tokenLength = line.length();
-    const char* tokenString = line.c_str();
+    PROFILE_ZONE("OBJ index");
+    IndexedModel result;
+    IndexedModel normalModel;
+
+    unsigned int numIndices = OBJIndices.size();
+
+    // Components the file does not have are ignored by the vertex keys. Most meshes
+    // have about as many vertices as their largest array of positions, uvs or normals.
+    unsigned int expectedVertices = std::max(vertices.size(), std::max(hasUVs ? uvs.size() : 0, hasNormals ? normals.size() : 0));
+    OBJVertexTable vertexTable(std::min(expectedVertices, numIndices), hasUVs, hasNormals);
+
+    // The normal model has one vertex per position, so that normals are smoothed
+    // across texture seams. Position index -> normal model vertex.
+    std::vector<unsigned int> normalModelIndexMap;
+    std::vector<unsigned int> indexMap;
+
+    if(!hasNormals)
+        normalModelIndexMap.resize(vertices.size(), OBJVertexTable::EMPTY);
 
-    unsigned int vertIndexStart = 2;
+    result.indices.reserve(numIndices);
 
-    while(vertIndexStart < tokenLength)
+    for(unsigned int i = 0; i < numIndices; i++)
     {
-        if(tokenString[vertIndexStart] != ' ')
-            break;
-        vertIndexStart++;
+        const OBJIndex& currentIndex = OBJIndices[i];
+
+        //Create model which properly separates texture coordinates
+        unsigned int resultModelIndex = vertexTable.insert(currentIndex, result.positions.size());
+
+        if(resultModelIndex == result.positions.size())
+        {
+            result.positions.push_back(vertices[currentIndex.vertexIndex]);
+            result.texCoords.push_back(hasUVs ? uvs[currentIndex.uvIndex] : Vector2());
+            result.normals.push_back(hasNormals ? normals[currentIndex.normalIndex] : Vector3());
+        }
+
+        result.indices.push_back(resultModelIndex);
+
+        if(hasNormals)
+            continue;
+
+        //Create model to properly generate normals on
+        unsigned int& normalModelIndex = normalModelIndexMap[currentIndex.vertexIndex];
+        if(normalModelIndex == OBJVertexTable::EMPTY)
+        {
+            normalModelIndex = normalModel.positions.size();
+            normalModel.positions.push_back(vertices[currentIndex.vertexIndex]);
+        }
+
+        normalModel.indices.push_back(normalModelIndex);
+
+        if(resultModelIndex == indexMap.size())
+            indexMap.push_back(normalModelIndex);
+    }
+
+    if(!hasNormals)
+    {
+        normalModel.CalcNormals(NORMAL_WEIGHT_ANGLE, jobSystem);
+
+        for(unsigned int i = 0; i < result.positions.size(); i++)
+            result.normals[i] = normalModel.normals[indexMap[i]];
     }
 
-    unsigned int vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, ' ');
+    return result;
+};
 
-    float x = ParseOBJFloatValue(line, vertIndexStart, vertIndexEnd);
+static inline bool IsOBJSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    vertIndexStart = vertIndexEnd + 1;
-    vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, ' ');
+static inline bool IsOBJDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
 
-    float y = ParseOBJFloatValue(line, vertIndexStart, vertIndexEnd);
+static inline void SkipOBJSpaces(const char*& cursor, const char* end)
+{
+    while(cursor < end && IsOBJSpace(*cursor))
+        cursor++;
+}
 
-    vertIndexStart = vertIndexEnd + 1;
-    vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, ' ');
+// Parses an integer at the cursor and moves the cursor past it.
+// Returns false if there are no digits.
+static inline bool ParseOBJInt(const char*& cursor, const char* end, int& value)
+{
+    bool negative = false;
+    if(cursor < end && (*cursor == '-' || *cursor == '+'))
+    {
+        negative = *cursor == '-';
+        cursor++;
+    }
 
-    float z = ParseOBJFloatValue(line, vertIndexStart, vertIndexEnd);
+    if(cursor >= end || !IsOBJDigit(*cursor))
+        return false;
 
-    return Vector3(x,y,z);
+    int result = 0;
+    while(cursor < end && IsOBJDigit(*cursor))
+        result = result * 10 + (*cursor++ - '0');
 
-    //glm::vec3(atof(tokens[1].c_str()), atof(tokens[2].c_str()), atof(tokens[3].c_str()))
+    value = negative ? -result : result;
+    return true;
 }
 
-Vector2 OBJModel::ParseOBJVec2(const std::string& line)
+// Parses a decimal float at the cursor without copying it into a string.
+// Up to 19 significant digits are kept in an integer, then scaled once by an
+// exact power of 10, so typical values are rounded correctly.
+static inline bool ParseOBJFloat(const char*& cursor, const char* end, float& value)
 {
-    unsigned int tokenLength = line.length();
-    const char* tokenString = line.c_str();
+    static const double powersOf10[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
 
-    unsigned int vertIndexStart = 3;
+    SkipOBJSpaces(cursor, end);
 
-    while(vertIndexStart < tokenLength)
+    bool negative = false;
+    if(cursor < end && (*cursor == '-' || *cursor == '+'))
     {
-        if(tokenString[vertIndexStart] != ' ')
-            break;
-        vertIndexStart++;
+        negative = *cursor == '-';
+        cursor++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    for(; cursor < end && IsOBJDigit(*cursor); cursor++)
+    {
+        anyDigit = true;
+        if(digits < 19)
+        {
+            mantissa = mantissa * 10 + (*cursor - '0');
+            digits += mantissa != 0;
+        }
+        else
+            exponent++;
+    }
+
+    if(cursor < end && *cursor == '.')
+    {
+        for(cursor++; cursor < end && IsOBJDigit(*cursor); cursor++)
+        {
+            anyDigit = true;
+            if(digits < 19)
+            {
+                mantissa = mantissa * 10 + (*cursor - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+        }
     }
 
-    unsigned int vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, ' ');
+    if(!anyDigit)
+        return false;
 
-    float x = ParseOBJFloatValue(line, vertIndexStart, vertIndexEnd);
+    if(cursor < end && (*cursor == 'e' || *cursor == 'E'))
+    {
+        const char* exponentStart = ++cursor;
+        int exponentValue = 0;
 
-    vertIndexStart = vertIndexEnd + 1;
-    vertIndexEnd = FindNextChar(vertIndexStart, tokenString, tokenLength, ' ');
+        if(ParseOBJInt(cursor, end, exponentValue))
+            exponent += exponentValue;
+        else
+            cursor = exponentStart;
+    }
 
-    float y = ParseOBJFloatValue(line, vertIndexStart, vertIndexEnd);
+    double result = static_cast<double>(mantissa);
+    if(exponent < -22 || exponent > 22)
+        result *= pow(10.0, exponent);
+    else if(exponent < 0)
+        result /= powersOf10[-exponent];
+    else
+        result *= powersOf10[exponent];
 
-    return Vector2(x,y);
+    value = static_cast<float>(negative ? -result : result);
+    return true;
 }
 
-static bool CompareOBJIndexPtr(const OBJIndex* a, const OBJIndex* b)
+// Converts a 1 based OBJ index to a 0 based one. Negative indices count back
+// from the last element read so far, which is relative to the chunk.
+static inline unsigned int ResolveOBJIndex(int index, unsigned int count, unsigned int component, unsigned int* relative)
 {
-    return a->vertexIndex < b->vertexIndex;
+    if(index < 0)
+    {
+        *relative |= component;
+        return count + index;
+    }
+
+    return index - 1;
 }
 
-static inline unsigned int FindNextChar(unsigned int start, const char* str, unsigned int length, char token)
+// Parses a face vertex like 1, 1/2, 1//3 or 1/2/3.
+static inline bool ParseOBJFaceIndex(const char*& cursor, const char* end, OBJChunk& chunk, OBJIndex& result, unsigned int* relative)
 {
-    unsigned int result = start;
-    while(result < length)
+    int value = 0;
+    if(!ParseOBJInt(cursor, end, value))
+        return false;
+
+    result.vertexIndex = ResolveOBJIndex(value, chunk.vertices.size(), OBJ_RELATIVE_VERTEX, relative);
+    result.uvIndex = 0;
+    result.normalIndex = 0;
+
+    if(cursor >= end || *cursor != '/')
+        return true;
+    cursor++;
+
+    if(ParseOBJInt(cursor, end, value))
     {
-        result++;
-        if(str[result] == token)
-            break;
+        result.uvIndex = ResolveOBJIndex(value, chunk.uvs.size(), OBJ_RELATIVE_UV, relative);
+        chunk.hasUVs = true;
     }
 
-    return result;
+    if(cursor >= end || *cursor != '/')
+        return true;
+    cursor++;
+
+    if(ParseOBJInt(cursor, end, value))
+    {
+        result.normalIndex = ResolveOBJIndex(value, chunk.normals.size(), OBJ_RELATIVE_NORMAL, relative);
+        chunk.hasNormals = true;
+    }
+
+    return true;
 }
 
-static inline unsigned int ParseOBJIndexValue(const std::string& token, unsigned int start, unsigned int end)
+static inline void AddOBJFaceIndex(OBJChunk& chunk, const OBJIndex& index, unsigned int relative)
 {
-    return atoi(token.substr(start, end - start).c_str()) - 1;
+    if(relative)
+    {
+        OBJRelativeIndex entry = { (unsigned int)chunk.indices.size(), relative };
+        chunk.relativeIndices.push_back(entry);
+    }
+
+    chunk.indices.push_back(index);
 }
 
-static inline float ParseOBJFloatValue(const std::string& token, unsigned int start, unsigned int end)
+static void ParseOBJFace(const char* cursor, const char* end, OBJChunk& chunk)
 {
-    return atof(token.substr(start, end - start).c_str());
+    OBJIndex first, previous, current;
+    unsigned int firstRelative = 0, previousRelative = 0;
+    unsigned int count = 0;
+
+    while(true)
+    {
+        SkipOBJSpaces(cursor, end);
+
+        unsigned int relative = 0;
+        if(!ParseOBJFaceIndex(cursor, end, chunk, current, &relative))
+            break;
+
+        // Fan out from the first vertex: (0, 1, 2), (0, 2, 3), ...
+        if(count >= 2)
+        {
+            AddOBJFaceIndex(chunk, first, firstRelative);
+            AddOBJFaceIndex(chunk, previous, previousRelative);
+            AddOBJFaceIndex(chunk, current, relative);
+        }
+
+        if(count == 0)
+        {
+            first = current;
+            firstRelative = relative;
+        }
+        previous = current;
+        previousRelative = relative;
+        count++;
+
+        // Skip anything left of a malformed vertex.
+        while(cursor < end && !IsOBJSpace(*cursor))
+            cursor++;
+    }
 }
 
-static inline std::vector<std::string> SplitString(const std::string &s, char delim)
+static void ParseOBJChunk(OBJChunk& chunk)
 {
-    std::vector<std::string> elems;
-
-    const char* cstr = s.c_str();
-    unsigned int strLength = s.length();
-    unsigned int start = 0;
-    unsigned int end = 0;
+    chunk.hasUVs = false;
+    chunk.hasNormals = false;
 
-    while(end <= strLength)
+    const char* cursor = chunk.begin;
+    while(cursor < chunk.end)
     {
-        while(end <= strLength)
+        const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', chunk.end - cursor));
+        if(!lineEnd)
+            lineEnd = chunk.end;
+
+        SkipOBJSpaces(cursor, lineEnd);
+
+        if(lineEnd - cursor >= 2)
         {
-            if(cstr[end] == delim)
+            const char* args = cursor + 2;
+            float x = 0, y = 0, z = 0;
+
+            switch(cursor[0])
+            {
+                case 'v':
+                    if(cursor[1] == 't')
+                    {
+                        ParseOBJFloat(args, lineEnd, x);
+                        ParseOBJFloat(args, lineEnd, y);
+                        chunk.uvs.push_back(Vector2(x, y));
+                    }
+                    else if(cursor[1] == 'n')
+                    {
+                        ParseOBJFloat(args, lineEnd, x);
+                        ParseOBJFloat(args, lineEnd, y);
+                        ParseOBJFloat(args, lineEnd, z);
+                        chunk.normals.push_back(Vector3(x, y, z));
+                    }
+                    else if(IsOBJSpace(cursor[1]))
+                    {
+                        args = cursor + 1;
+                        ParseOBJFloat(args, lineEnd, x);
+                        ParseOBJFloat(args, lineEnd, y);
+                        ParseOBJFloat(args, lineEnd, z);
+                        chunk.vertices.push_back(Vector3(x, y, z));
+                    }
+                break;
+                case 'f':
+                    if(IsOBJSpace(cursor[1]))
+                        ParseOBJFace(cursor + 1, lineEnd, chunk);
                 break;
-            end++;
+                default: break;
+            };
         }
 
-        elems.push_back(s.substr(start, end - start));
-        start = end + 1;
-        end = start;
+        cursor = lineEnd + 1;
     }
-
-    return elems;
 }
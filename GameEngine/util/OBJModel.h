@@ -9,6 +9,9 @@
 
 #include "../math/Vector3.h"
 #include "../math/Vector2.h"
+#include "../math/Vector4.h"
+
+class JobSystem;
 
 struct OBJIndex
 {
@@ -19,15 +22,44 @@ struct OBJIndex
     bool operator<(const OBJIndex& r) const { return vertexIndex < r.vertexIndex; }
 };
 
+// How the triangles around a vertex are weighted into its normal.
+enum NormalWeighting
+{
+    // Every triangle counts the same.
+    NORMAL_WEIGHT_UNIFORM,
+
+    // Triangles count by their area.
+    NORMAL_WEIGHT_AREA,
+
+    // Triangles count by their angle at the vertex, so the normal does not
+    // depend on how the surface around it was cut into triangles.
+    NORMAL_WEIGHT_ANGLE
+};
+
 class IndexedModel
 {
 public:
     std::vector<Vector3> positions;
     std::vector<Vector2> texCoords;
     std::vector<Vector3> normals;
+
+    // The direction of increasing u, with the sign of the bitangent in w:
+    // bitangent = w * normal.cross(tangent). Empty until CalcTangents() is called.
+    std::vector<Vector4> tangents;
+
     std::vector<unsigned int> indices;
 
-    void CalcNormals();
+    // Replaces the normals with the weighted average of the triangles around each vertex.
+    // With a job system, large models are split over the threads. Each vertex sums its
+    // triangles in the same order either way, so the result does not change.
+    void CalcNormals(NormalWeighting weighting = NORMAL_WEIGHT_ANGLE, JobSystem* jobSystem = nullptr);
+
+    // Generates tangents that match MikkTSpace, the tangent space most bakers
+    // use for normal maps: per triangle tangents projected onto the vertex normal
+    // and weighted by the corner angles. Unlike MikkTSpace, vertices are not split
+    // where mirrored uvs meet; they take the handedness of most of their angle.
+    // Normals are generated first if the model has none.
+    void CalcTangents(JobSystem* jobSystem = nullptr);
 };
 
 class OBJModel
@@ -40,17 +72,15 @@ public:
     bool hasUVs;
     bool hasNormals;
 
-    OBJModel(const std::string& fileName);
-
-    IndexedModel ToIndexedModel();
-
-private:
-    unsigned int FindLastVertexIndex(const std::vector<OBJIndex*>& indexLookup, const OBJIndex* currentIndex, const IndexedModel& result);
-    void CreateOBJFace(const std::string& line);
+    // The file is memory mapped and cut into chunks of whole lines. With a job
+    // system the chunks are parsed in parallel, then merged in file order.
+    // Faces with more than 3 vertices are split into a triangle fan. Triangles
+    // with an index out of range are dropped, with an error.
+    OBJModel(const std::string& fileName, JobSystem* jobSystem = nullptr);
 
-    Vector2 ParseOBJVec2(const std::string& line);
-    Vector3 ParseOBJVec3(const std::string& line);
-    OBJIndex ParseOBJIndex(const std::string& token, bool* hasUVs, bool* hasNormals);
+    // Creates one vertex per distinct (position, uv, normal) index triple.
+    // Normals are generated if the file has none, on the job system if there is one.
+    IndexedModel ToIndexedModel(JobSystem* jobSystem = nullptr);
 };
 
 #endif // OBJMODEL_H
@@ -0,0 +1,320 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+struct ZoneRecord{
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// A record in a thread buffer. The owning thread may overwrite it while
+// gatherRecords() copies it, so the fields are atomic (relaxed, plain moves on x86).
+struct SharedZoneRecord{
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> end;
+};
+
+// A ring of the zones finished by one thread.
+// Only the owning thread writes it, and only gatherRecords() reads it.
+class ProfilerThreadBuffer
+{
+public:
+    ProfilerThreadBuffer(unsigned threadId) : claimed(0), written(0), read(0), threadId(threadId), namedInTrace(false) {}
+
+    SharedZoneRecord records[Profiler::THREAD_BUFFER_SIZE];
+
+    // The number of records ever started, finished, and read. A record is started
+    // before its slot is overwritten, so a reader that copied a slot can tell
+    // afterwards whether the copy may be torn (a seqlock).
+    std::atomic<uint64_t> claimed;
+    std::atomic<uint64_t> written;
+    uint64_t read;
+
+    // The order in which the thread first recorded a zone.
+    unsigned threadId;
+    bool namedInTrace;
+};
+
+const unsigned Profiler::THREAD_BUFFER_SIZE;
+const unsigned Profiler::HISTORY_SIZE;
+
+vector<ProfilerThreadBuffer*> Profiler::threadBuffers;
+std::mutex Profiler::threadBuffersMutex;
+std::map<string, Profiler::ZoneHistory> Profiler::zones;
+std::unordered_map<const char*, Profiler::ZoneHistory*> Profiler::zonesByName;
+
+// The records copied out of a thread buffer by gatherRecords().
+static vector<ZoneRecord> gatheredRecords;
+
+std::ofstream Profiler::traceFile;
+uint64_t Profiler::traceStart = 0;
+bool Profiler::traceFirstEvent = true;
+
+Profiler::ZoneHistory::ZoneHistory() : count(0), next(0), frameNanoseconds(0), ranThisFrame(false)
+{}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end){
+
+    ProfilerThreadBuffer& buffer = getThreadBuffer();
+
+    uint64_t written = buffer.written.load(std::memory_order_relaxed);
+
+    // Tell readers the slot is about to change before changing it.
+    buffer.claimed.store(written + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SharedZoneRecord& record = buffer.records[written % THREAD_BUFFER_SIZE];
+    record.name.store(name, std::memory_order_relaxed);
+    record.start.store(start, std::memory_order_relaxed);
+    record.end.store(end, std::memory_order_relaxed);
+
+    // Publish the record to gatherRecords().
+    buffer.written.store(written + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame(){
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    gatherRecords();
+
+    for (auto& entry : zones){
+        ZoneHistory& zone = entry.second;
+        if (!zone.ranThisFrame)
+            continue;
+
+        zone.frameMilliseconds[zone.next] = zone.frameNanoseconds / 1e6;
+        zone.next = (zone.next + 1) % HISTORY_SIZE;
+        if (zone.count < HISTORY_SIZE)
+            zone.count++;
+
+        zone.frameNanoseconds = 0;
+        zone.ranThisFrame = false;
+    }
+}
+
+void Profiler::getZoneStats(vector<ZoneStats>& stats){
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    stats.clear();
+    for (const auto& entry : zones){
+        const ZoneHistory& zone = entry.second;
+        if (zone.count == 0)
+            continue;
+
+        vector<float> sorted(zone.frameMilliseconds, zone.frameMilliseconds + zone.count);
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0;
+        for (float milliseconds : sorted)
+            total += milliseconds;
+
+        ZoneStats zoneStats;
+        zoneStats.name = entry.first;
+        zoneStats.frames = zone.count;
+        zoneStats.minMilliseconds = sorted.front();
+        zoneStats.avgMilliseconds = total / zone.count;
+        zoneStats.maxMilliseconds = sorted.back();
+
+        // The smallest time that 99% of the frames do not exceed.
+        zoneStats.p99Milliseconds = sorted[(zone.count * 99 + 99) / 100 - 1];
+
+        stats.push_back(zoneStats);
+    }
+}
+
+void Profiler::report(std::ostream& out){
+
+    vector<ZoneStats> stats;
+    getZoneStats(stats);
+
+    out << "Zone times per frame in ms (min / avg / max / p99):\n";
+
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    for (const ZoneStats& zone : stats){
+        out << "  " << std::left << std::setw(24) << zone.name << std::right
+            << std::setw(9) << zone.minMilliseconds
+            << std::setw(9) << zone.avgMilliseconds
+            << std::setw(9) << zone.maxMilliseconds
+            << std::setw(9) << zone.p99Milliseconds
+            << "  (" << zone.frames << " frames)\n";
+    }
+
+    out.flags(flags);
+}
+
+bool Profiler::startTrace(const string& filePath){
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    if (traceFile.is_open()){
+        std::cerr << "Error. A trace is already being written.\n";
+        return false;
+    }
+
+    // Leave out what was recorded before the trace started.
+    gatherRecords();
+
+    traceFile.open(filePath.c_str(), std::ios::out | std::ios::trunc);
+    if (!traceFile.is_open()){
+        std::cerr << "Error. Failed to open the trace file " << filePath << std::endl;
+        return false;
+    }
+
+    traceFile << "{\"traceEvents\":[\n";
+    traceStart = Timer::now();
+    traceFirstEvent = true;
+
+    for (ProfilerThreadBuffer* buffer : threadBuffers)
+        buffer->namedInTrace = false;
+
+    return true;
+}
+
+void Profiler::stopTrace(){
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    if (!traceFile.is_open())
+        return;
+
+    // Write the zones finished since the last frame.
+    gatherRecords();
+
+    traceFile << "\n]}\n";
+    traceFile.close();
+}
+
+bool Profiler::isTracing(){
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+    return traceFile.is_open();
+}
+
+void Profiler::destroyThreadBuffers(){
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    for (ProfilerThreadBuffer* buffer : threadBuffers)
+        delete buffer;
+
+    threadBuffers.clear();
+}
+
+ProfilerThreadBuffer& Profiler::getThreadBuffer(){
+
+    static thread_local ProfilerThreadBuffer* buffer = nullptr;
+
+    if (!buffer){
+        std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+        buffer = new ProfilerThreadBuffer(threadBuffers.size());
+        threadBuffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+void Profiler::gatherRecords(){
+
+    bool tracing = traceFile.is_open();
+
+    for (ProfilerThreadBuffer* buffer : threadBuffers){
+
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+
+        // Skip what was overwritten since the last frame.
+        if (written - buffer->read > THREAD_BUFFER_SIZE)
+            buffer->read = written - THREAD_BUFFER_SIZE;
+
+        if (tracing && !buffer->namedInTrace && buffer->read < written){
+            writeThreadName(buffer->threadId);
+            buffer->namedInTrace = true;
+        }
+
+        uint64_t first = buffer->read;
+        gatheredRecords.resize(written - first);
+
+        for (uint64_t i = first; i < written; i++){
+            const SharedZoneRecord& shared = buffer->records[i % THREAD_BUFFER_SIZE];
+            ZoneRecord& record = gatheredRecords[i - first];
+            record.name = shared.name.load(std::memory_order_relaxed);
+            record.start = shared.start.load(std::memory_order_relaxed);
+            record.end = shared.end.load(std::memory_order_relaxed);
+        }
+
+        buffer->read = written;
+
+        // Drop the copies of slots the thread started overwriting meanwhile.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+        uint64_t firstIntact = claimed > THREAD_BUFFER_SIZE ? claimed - THREAD_BUFFER_SIZE : 0;
+
+        for (uint64_t i = std::max(first, firstIntact); i < written; i++){
+            const ZoneRecord& record = gatheredRecords[i - first];
+
+            ZoneHistory*& zone = zonesByName[record.name];
+            if (!zone)
+                zone = &zones[record.name];
+
+            zone->frameNanoseconds += record.end - record.start;
+            zone->ranThisFrame = true;
+
+            if (tracing)
+                writeTraceEvent(record.name, buffer->threadId, record.start, record.end);
+        }
+    }
+}
+
+// Writes the string quoted and escaped for JSON.
+static void writeJsonString(std::ostream& out, const char* text){
+    out << '"';
+    for (const char* c = text; *c; c++){
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) >= 0x20)
+            out << *c;
+    }
+    out << '"';
+}
+
+void Profiler::writeTraceEvent(const char* name, unsigned threadId, uint64_t start, uint64_t end){
+
+    if (!traceFirstEvent)
+        traceFile << ",\n";
+    traceFirstEvent = false;
+
+    // Complete events, with times in microseconds since the trace started.
+    // Zones that began before the trace start at 0.
+    uint64_t begin = start > traceStart ? start - traceStart : 0;
+    uint64_t duration = end > traceStart ? end - traceStart - begin : 0;
+
+    traceFile << "{\"name\":";
+    writeJsonString(traceFile, name);
+    traceFile << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadId
+              << ",\"ts\":" << begin / 1000 << '.' << std::setw(3) << std::setfill('0') << begin % 1000
+              << ",\"dur\":" << duration / 1000 << '.' << std::setw(3) << duration % 1000
+              << std::setfill(' ') << '}';
+}
+
+void Profiler::writeThreadName(unsigned threadId){
+
+    if (!traceFirstEvent)
+        traceFile << ",\n";
+    traceFirstEvent = false;
+
+    // The first thread to record a zone is the one running the engine.
+    traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadId
+              << ",\"args\":{\"name\":\"";
+    if (threadId == 0)
+        traceFile << "Main";
+    else
+        traceFile << "Thread " << threadId;
+    traceFile << "\"}}";
+}
@@ -0,0 +1,131 @@
+/*
+    Measures how long named zones of code take, on every thread.
+    Put PROFILE_ZONE("Name") at the start of a block to time the rest of the block.
+    Define PROFILER_DISABLED to compile every zone out.
+    The zones can also be streamed to a Chrome trace event file, which can be
+    opened in chrome://tracing or https://ui.perfetto.dev.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <ostream>
+#include <mutex>
+#include <fstream>
+
+#include "Timer.h"
+
+using std::vector;
+using std::string;
+
+// The time spent in a zone per frame, over the recent frames it ran in.
+struct ZoneStats{
+    string name;
+    unsigned frames;
+
+    double minMilliseconds;
+    double avgMilliseconds;
+    double maxMilliseconds;
+    double p99Milliseconds;
+};
+
+class ProfilerThreadBuffer;
+
+class Profiler
+{
+public:
+
+    // Stores a finished zone of the calling thread. Zone names must outlive the profiler.
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    // Adds the zones finished since the last call to the history of their zone.
+    // Called by the engine once per frame.
+    static void endFrame();
+
+    static void getZoneStats(vector<ZoneStats>& stats);
+
+    // Writes the stats of every zone.
+    static void report(std::ostream& out);
+
+    // Starts writing every finished zone to the trace file, replacing it.
+    static bool startTrace(const string& filePath);
+    static void stopTrace();
+    static bool isTracing();
+
+    static void destroyThreadBuffers();
+
+    // The number of zones kept per thread between two frames. Older zones are overwritten.
+    static const unsigned THREAD_BUFFER_SIZE = 8192;
+
+    // The number of frames the stats are computed over.
+    static const unsigned HISTORY_SIZE = 240;
+
+private:
+
+    struct ZoneHistory{
+        ZoneHistory();
+
+        float frameMilliseconds[HISTORY_SIZE];
+        unsigned count;
+        unsigned next;
+
+        // Accumulates the zone time of the frame being gathered.
+        uint64_t frameNanoseconds;
+        bool ranThisFrame;
+    };
+
+    static ProfilerThreadBuffer& getThreadBuffer();
+
+    // Reads the records written since the last call into the zone times of the
+    // frame, and the trace if one is running.
+    static void gatherRecords();
+
+    static void writeTraceEvent(const char* name, unsigned threadId, uint64_t start, uint64_t end);
+    static void writeThreadName(unsigned threadId);
+
+    static vector<ProfilerThreadBuffer*> threadBuffers;
+    static std::mutex threadBuffersMutex;
+
+    // Sorted by name for the report.
+    static std::map<string, ZoneHistory> zones;
+
+    // The zones by the address of their name, so gathering does not build a string
+    // per record. Names with the same text at different addresses share a zone.
+    static std::unordered_map<const char*, ZoneHistory*> zonesByName;
+
+    // The trace is written as the records are gathered, so its memory use stays bounded.
+    static std::ofstream traceFile;
+    static uint64_t traceStart;
+    static bool traceFirstEvent;
+};
+
+// Times its own lifetime.
+class ProfilerZone
+{
+public:
+    ProfilerZone(const char* name) : name(name), start(Timer::now()) {}
+    ~ProfilerZone(){ Profiler::record(name, start, Timer::now()); }
+
+private:
+    ProfilerZone(const ProfilerZone&) = delete;
+    ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+    const char* name;
+    uint64_t start;
+};
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE(name) ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+#endif
+
+#endif // PROFILER_H
@@ -1,17 +1,27 @@
 #include "Timer.h"
 
+#include <chrono>
+
 Timer::Timer() : start_time(0)
 {}
 
 void Timer::start(){
-    start_time = SDL_GetTicks();
+    start_time = now();
 }
 
 float Timer::getElapsedSeconds() const{
 
-    // Get the elapsed time since the call of start() in milliseconds
-    float milli = SDL_GetTicks() - start_time;
+    // Convert from nanoseconds. Done in double, a float can not hold the nanoseconds precisely.
+    return getElapsedNanoseconds() / 1e9;
+}
+
+uint64_t Timer::getElapsedNanoseconds() const{
+    return now() - start_time;
+}
+
+uint64_t Timer::now(){
 
-    // Convert to seconds
-    return milli / 1000;
+    // The steady clock never goes back, unlike the system clock.
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
 }
@@ -1,7 +1,7 @@
 #ifndef TIMER_H
 #define TIMER_H
 
-#include <SDL2/SDL.h>
+#include <cstdint>
 
 class Timer
 {
@@ -15,8 +15,14 @@ class Timer
         // Get the number of seconds since the last call to start()
         float getElapsedSeconds() const;
 
+        // Get the number of nanoseconds since the last call to start()
+        uint64_t getElapsedNanoseconds() const;
+
+        // A monotonic clock in nanoseconds. Only differences between readings are meaningful.
+        static uint64_t now();
+
     private:
-        Uint32 start_time;
+        uint64_t start_time;
 };
 
 #endif // TIMER_H
@@ -0,0 +1,288 @@
+#include "VertexLayout.h"
+#include "OBJModel.h"
+
+#include <cstring>
+#include <cmath>
+
+static_assert(sizeof(VertexLayout) == 8, "VertexLayout is stored in cooked mesh files");
+
+// The formats each attribute can be stored in, see create().
+static bool isValidFormat(VertexAttribute attribute, VertexFormat format){
+    switch (attribute){
+        case VERTEX_POSITION:   return format == FORMAT_FLOAT3;
+        case VERTEX_UV:         return format == FORMAT_NONE || format == FORMAT_FLOAT2 || format == FORMAT_HALF2;
+        case VERTEX_NORMAL:     return format == FORMAT_NONE || format == FORMAT_FLOAT3 || format == FORMAT_SNORM_10_10_10_2;
+        default:                return false;
+    }
+}
+
+VertexLayout VertexLayout::full(){
+    return create(FORMAT_FLOAT3, FORMAT_FLOAT2, FORMAT_FLOAT3);
+}
+
+VertexLayout VertexLayout::compact(){
+    return create(FORMAT_FLOAT3, FORMAT_HALF2, FORMAT_SNORM_10_10_10_2);
+}
+
+VertexLayout VertexLayout::create(VertexFormat position, VertexFormat uv, VertexFormat normal){
+    VertexFormat requested[NUM_VERTEX_ATTRIBUTES] = { position, uv, normal };
+
+    VertexLayout layout;
+    unsigned offset = 0;
+
+    for (unsigned i = 0; i < NUM_VERTEX_ATTRIBUTES; i++){
+
+        // Fall back on floats for a format the attribute does not support.
+        VertexFormat format = requested[i];
+        if (!isValidFormat(VertexAttribute(i), format))
+            format = i == VERTEX_UV ? FORMAT_FLOAT2 : FORMAT_FLOAT3;
+
+        layout.formats[i] = format;
+        layout.offsets[i] = offset;
+
+        // Every format is a multiple of 4 bytes, which keeps the attributes aligned.
+        offset += getFormatSize(format);
+    }
+
+    layout.stride = offset;
+    return layout;
+}
+
+bool VertexLayout::has(VertexAttribute attribute) const{
+    return formats[attribute] != FORMAT_NONE;
+}
+
+VertexFormat VertexLayout::getFormat(VertexAttribute attribute) const{
+    return VertexFormat(formats[attribute]);
+}
+
+unsigned VertexLayout::getOffset(VertexAttribute attribute) const{
+    return offsets[attribute];
+}
+
+unsigned VertexLayout::getStride() const{
+    return stride;
+}
+
+// Stores up to 3 components in the format.
+static void writeAttribute(char* destination, VertexFormat format, const float* components){
+    switch (format){
+        case FORMAT_FLOAT2:
+            memcpy(destination, components, 2 * sizeof(float));
+        break;
+        case FORMAT_FLOAT3:
+            memcpy(destination, components, 3 * sizeof(float));
+        break;
+        case FORMAT_HALF2:{
+            uint16_t halves[2] = { floatToHalf(components[0]), floatToHalf(components[1]) };
+            memcpy(destination, halves, sizeof(halves));
+        }
+        break;
+        case FORMAT_SNORM_10_10_10_2:{
+            uint32_t packed = packSNorm10(Vector3(components[0], components[1], components[2]));
+            memcpy(destination, &packed, sizeof(packed));
+        }
+        break;
+        default: break;
+    }
+}
+
+static void readAttribute(const char* source, VertexFormat format, float* components){
+    switch (format){
+        case FORMAT_FLOAT2:
+            memcpy(components, source, 2 * sizeof(float));
+        break;
+        case FORMAT_FLOAT3:
+            memcpy(components, source, 3 * sizeof(float));
+        break;
+        case FORMAT_HALF2:{
+            uint16_t halves[2];
+            memcpy(halves, source, sizeof(halves));
+            components[0] = halfToFloat(halves[0]);
+            components[1] = halfToFloat(halves[1]);
+        }
+        break;
+        case FORMAT_SNORM_10_10_10_2:{
+            uint32_t packed;
+            memcpy(&packed, source, sizeof(packed));
+            Vector3 unpacked = unpackSNorm10(packed);
+            components[0] = unpacked.x;
+            components[1] = unpacked.y;
+            components[2] = unpacked.z;
+        }
+        break;
+        default: break;
+    }
+}
+
+void VertexLayout::write(void* vertex, const Vector3& position, const Vector2& uv, const Vector3& normal) const{
+    char* bytes = static_cast<char*>(vertex);
+    writeAttribute(bytes + offsets[VERTEX_POSITION], getFormat(VERTEX_POSITION), &position.components[0]);
+    writeAttribute(bytes + offsets[VERTEX_UV], getFormat(VERTEX_UV), &uv.components[0]);
+    writeAttribute(bytes + offsets[VERTEX_NORMAL], getFormat(VERTEX_NORMAL), &normal.components[0]);
+}
+
+void VertexLayout::read(const void* vertex, Vector3& position, Vector2& uv, Vector3& normal) const{
+    const char* bytes = static_cast<const char*>(vertex);
+    position = Vector3();
+    uv = Vector2();
+    normal = Vector3();
+    readAttribute(bytes + offsets[VERTEX_POSITION], getFormat(VERTEX_POSITION), &position.components[0]);
+    readAttribute(bytes + offsets[VERTEX_UV], getFormat(VERTEX_UV), &uv.components[0]);
+    readAttribute(bytes + offsets[VERTEX_NORMAL], getFormat(VERTEX_NORMAL), &normal.components[0]);
+}
+
+void VertexLayout::writeModel(void* vertices, const IndexedModel& model) const{
+    char* destination = static_cast<char*>(vertices);
+
+    for (unsigned i = 0; i < model.positions.size(); i++){
+        Vector2 uv = i < model.texCoords.size() ? model.texCoords[i] : Vector2();
+        Vector3 normal = i < model.normals.size() ? model.normals[i] : Vector3(0, 0, 1);
+        write(destination + i * stride, model.positions[i], uv, normal);
+    }
+}
+
+bool VertexLayout::operator==(const VertexLayout& other) const{
+    return memcmp(formats, other.formats, sizeof(formats)) == 0
+        && memcmp(offsets, other.offsets, sizeof(offsets)) == 0
+        && stride == other.stride;
+}
+
+bool VertexLayout::operator!=(const VertexLayout& other) const{
+    return !(*this == other);
+}
+
+const char* VertexLayout::getAttributeName(VertexAttribute attribute){
+    switch (attribute){
+        case VERTEX_POSITION:   return "position";
+        case VERTEX_UV:         return "tex_coord";
+        case VERTEX_NORMAL:     return "normal";
+        default:                return "";
+    }
+}
+
+unsigned VertexLayout::getFormatSize(VertexFormat format){
+    switch (format){
+        case FORMAT_FLOAT2:             return 2 * sizeof(float);
+        case FORMAT_FLOAT3:             return 3 * sizeof(float);
+        case FORMAT_HALF2:              return 2 * sizeof(uint16_t);
+        case FORMAT_SNORM_10_10_10_2:   return sizeof(uint32_t);
+        default:                        return 0;
+    }
+}
+
+unsigned VertexLayout::getComponentCount(VertexFormat format){
+    switch (format){
+        case FORMAT_FLOAT2:             return 2;
+        case FORMAT_FLOAT3:             return 3;
+        case FORMAT_HALF2:              return 2;
+        case FORMAT_SNORM_10_10_10_2:   return 4;
+        default:                        return 0;
+    }
+}
+
+unsigned getIndexSize(unsigned vertexCount){
+    return vertexCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+void writeIndices(void* destination, const unsigned* indices, unsigned count, unsigned indexSize){
+    if (indexSize == sizeof(uint32_t)){
+        memcpy(destination, indices, count * sizeof(uint32_t));
+        return;
+    }
+
+    uint16_t* narrow = static_cast<uint16_t*>(destination);
+    for (unsigned i = 0; i < count; i++)
+        narrow[i] = static_cast<uint16_t>(indices[i]);
+}
+
+uint16_t floatToHalf(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN
+    if (exponent == 0xFF)
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+    int halfExponent = int(exponent) - 127 + 15;
+
+    // Too large, becomes infinity.
+    if (halfExponent >= 0x1F)
+        return sign | 0x7C00;
+
+    // Too small for a normal half. Shift the mantissa, with its implicit 1, into a subnormal.
+    if (halfExponent <= 0){
+        if (halfExponent < -10)
+            return sign;
+
+        mantissa |= 0x800000;
+        unsigned shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+
+        // Round to nearest, ties to even.
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return sign | half;
+    }
+
+    uint32_t half = (uint32_t(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+
+    // A carry out of the mantissa correctly moves on to the next exponent.
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+
+    return sign | half;
+}
+
+float halfToFloat(uint16_t half){
+    uint32_t sign = uint32_t(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    if (exponent == 0){
+        float value = ldexpf(float(mantissa), -24);
+        return sign ? -value : value;
+    }
+
+    uint32_t bits;
+    if (exponent == 0x1F)
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    else
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint32_t packSNorm10(const Vector3& direction){
+    uint32_t packed = 0;
+
+    for (unsigned i = 0; i < 3; i++){
+        float component = std::fmax(-1.0f, std::fmin(1.0f, direction[i]));
+        int value = int(lroundf(component * 511));
+        packed |= (uint32_t(value) & 0x3FF) << (i * 10);
+    }
+
+    return packed;
+}
+
+Vector3 unpackSNorm10(uint32_t packed){
+    Vector3 direction;
+
+    for (unsigned i = 0; i < 3; i++){
+
+        // Sign extend the 10 bits.
+        int value = int32_t(packed << (22 - i * 10)) >> 22;
+        direction[i] = std::fmax(value / 511.0f, -1.0f);
+    }
+
+    return direction;
+}
@@ -0,0 +1,90 @@
+/*
+    Describes how the attributes of a vertex are packed in an interleaved vertex buffer.
+    Every attribute can be stored at full precision or quantized:
+        UVs as half floats (exact to about 1/2048 inside [0, 1]).
+        Normals as signed normalized 10-10-10-2 integers (about 0.002 error).
+    The compact layout (12 + 4 + 4 = 20 bytes) is well under the 32 bytes of all floats.
+*/
+
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+#include <cstdint>
+
+#include "../math/Vector3.h"
+#include "../math/Vector2.h"
+
+class IndexedModel;
+
+// The attributes of a vertex. The value is the location bound in the shaders.
+enum VertexAttribute{
+    VERTEX_POSITION,
+    VERTEX_UV,
+    VERTEX_NORMAL,
+    NUM_VERTEX_ATTRIBUTES
+};
+
+enum VertexFormat{
+    FORMAT_NONE,
+    FORMAT_FLOAT2,
+    FORMAT_FLOAT3,
+    FORMAT_HALF2,
+
+    // x, y and z in 10 bits each, w in the last 2 bits (GL_INT_2_10_10_10_REV).
+    FORMAT_SNORM_10_10_10_2
+};
+
+// Plain data, so it can be stored as is in cooked mesh files.
+struct VertexLayout{
+
+    // Positions, uvs and normals as floats.
+    static VertexLayout full();
+
+    // Float positions, half float uvs and 10-10-10-2 normals.
+    static VertexLayout compact();
+
+    // Attributes are packed in order, each starting on 4 bytes.
+    static VertexLayout create(VertexFormat position, VertexFormat uv, VertexFormat normal);
+
+    bool has(VertexAttribute) const;
+    VertexFormat getFormat(VertexAttribute) const;
+    unsigned getOffset(VertexAttribute) const;
+    unsigned getStride() const;
+
+    // Packs one vertex at 'vertex', which must hold getStride() bytes.
+    void write(void* vertex, const Vector3& position, const Vector2& uv, const Vector3& normal) const;
+
+    // Unpacks one vertex. Missing attributes are set to 0.
+    void read(const void* vertex, Vector3& position, Vector2& uv, Vector3& normal) const;
+
+    // Packs every vertex of the model one after the other.
+    void writeModel(void* vertices, const IndexedModel& model) const;
+
+    bool operator==(const VertexLayout&) const;
+    bool operator!=(const VertexLayout&) const;
+
+    // The name of the attribute in the shaders.
+    static const char* getAttributeName(VertexAttribute);
+
+    static unsigned getFormatSize(VertexFormat);
+    static unsigned getComponentCount(VertexFormat);
+
+    uint8_t formats[NUM_VERTEX_ATTRIBUTES];
+    uint8_t offsets[NUM_VERTEX_ATTRIBUTES];
+    uint16_t stride;
+};
+
+// Indices fit in 16 bits while no vertex index goes above 65535.
+unsigned getIndexSize(unsigned vertexCount);
+
+// Copies the indices, narrowed to 16 bits if the index size is 2.
+void writeIndices(void* destination, const unsigned* indices, unsigned count, unsigned indexSize);
+
+uint16_t floatToHalf(float);
+float halfToFloat(uint16_t);
+
+// Packs a direction with components in [-1, 1] (w = 0).
+uint32_t packSNorm10(const Vector3&);
+Vector3 unpackSNorm10(uint32_t);
+
+#endif // VERTEXLAYOUT_H